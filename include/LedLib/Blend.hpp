@@ -0,0 +1,140 @@
+#pragma once
+#include "Color.hpp"
+namespace LedLib
+{
+    /**
+     * @brief How a layer is combined with the layers below it
+     */
+    enum class BlendMode : uint8_t
+    {
+        Normal,   // the layer replaces what is below
+        Add,      // channels are added, saturating at 255
+        Multiply, // channels are multiplied, darkening
+        Screen,   // inverse of multiply, brightening
+        Max       // the brighter of each channel
+    };
+
+    /**
+     * @brief The shape of a transition over time
+     */
+    enum class Easing : uint8_t
+    {
+        Linear,
+        EaseIn,   // starts slow, finishes fast
+        EaseOut,  // starts fast, finishes slow
+        EaseInOut // slow at both ends
+    };
+
+    /// Integer blend kernels. Everything works on packed 0xRRGGBB words, several channels per operation where possible.
+    namespace Blend
+    {
+        /**
+         * @brief Per channel saturating add in one word
+         *
+         * The low 7 bits of every channel are added without crossing into the next channel, then the top bits are
+         * folded back in and any channel that carried out is forced to 255.
+         */
+        constexpr Color add(Color below, Color above)
+        {
+            uint32_t a = below.value;
+            uint32_t b = above.value;
+            uint32_t sum = (a & 0x7F7F7F) + (b & 0x7F7F7F);
+            uint32_t carry = ((a & b) | ((a | b) & sum)) & 0x808080;
+            uint32_t result = sum ^ ((a ^ b) & 0x808080);
+            return result | ((carry >> 7) * 0xFF);
+        }
+
+        constexpr Color multiply(Color below, Color above)
+        {
+            return Color(Color::div255(below.red() * above.red()),
+                         Color::div255(below.green() * above.green()),
+                         Color::div255(below.blue() * above.blue()));
+        }
+
+        /**
+         * @brief 1 - (1 - below) * (1 - above), done as a multiply of the inverted colors
+         */
+        constexpr Color screen(Color below, Color above)
+        {
+            return multiply(below.value ^ 0xFFFFFF, above.value ^ 0xFFFFFF).value ^ 0xFFFFFF;
+        }
+
+        constexpr Color max(Color below, Color above)
+        {
+            return Color(below.red() > above.red() ? below.red() : above.red(),
+                         below.green() > above.green() ? below.green() : above.green(),
+                         below.blue() > above.blue() ? below.blue() : above.blue());
+        }
+
+        /**
+         * @brief Blend a single pixel
+         *
+         * @param below the color already in place
+         * @param above the layer color
+         * @param mode how to combine them
+         * @param opacity 0-255 strength of the layer, applied as a lerp from below to the blended color
+         */
+        constexpr Color pixel(Color below, Color above, BlendMode mode, uint8_t opacity)
+        {
+            Color blended = above;
+            switch (mode)
+            {
+            case BlendMode::Normal:
+                break;
+            case BlendMode::Add:
+                blended = add(below, above);
+                break;
+            case BlendMode::Multiply:
+                blended = multiply(below, above);
+                break;
+            case BlendMode::Screen:
+                blended = screen(below, above);
+                break;
+            case BlendMode::Max:
+                blended = max(below, above);
+                break;
+            }
+            if (opacity == 255)
+                return blended;
+            return Color::lerp(below, blended, opacity);
+        }
+
+        /**
+         * @brief Map linear progress through an easing curve using integer math
+         *
+         * @param curve the curve to apply
+         * @param progress 0-255 fraction of the transition that has elapsed
+         * @return 0-255 amount to blend
+         */
+        constexpr uint8_t ease(Easing curve, uint8_t progress)
+        {
+            uint32_t t = progress;
+            switch (curve)
+            {
+            case Easing::EaseIn:
+                return Color::div255(t * t);
+            case Easing::EaseOut:
+                return 255 - Color::div255((255 - t) * (255 - t));
+            case Easing::EaseInOut:
+                if (t < 128)
+                    return Color::div255(2 * t * t);
+                return 255 - Color::div255(2 * (255 - t) * (255 - t));
+            default:
+                return progress;
+            }
+        }
+
+        /**
+         * @brief Blend a whole row of pixels in one pass
+         *
+         * The mode and opacity are resolved once outside the loop, so each pixel only runs its kernel.
+         *
+         * @param below the pixels to blend into, overwritten with the result
+         * @param above the layer pixels
+         * @param count the number of pixels
+         * @param mode how to combine them
+         * @param opacity 0-255 strength of the layer
+         */
+        void row(Color *below, const Color *above, int count, BlendMode mode, uint8_t opacity);
+    }
+};
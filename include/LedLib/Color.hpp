@@ -0,0 +1,146 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+namespace LedLib
+{
+    struct RGB
+    {
+        int red;
+        int green;
+        int blue;
+    };
+
+    struct HSV
+    {
+        double hue = 0;
+        double saturation = 0;
+        double value = 0;
+    };
+
+    /**
+     * @brief A color packed into 4 bytes as 0xRRGGBB
+     *
+     * This is the same layout the strip expects, so a frame of Colors can be handed to the hardware as-is.
+     * Constructing from a uint32_t is implicit so hex literals work anywhere a Color is taken.
+     */
+    struct Color
+    {
+        uint32_t value;
+
+        constexpr Color() : value(0) {}
+        constexpr Color(uint32_t color) : value(color) {}
+        constexpr Color(uint8_t red, uint8_t green, uint8_t blue)
+            : value((static_cast<uint32_t>(red) << 16) | (static_cast<uint32_t>(green) << 8) | blue) {}
+
+        constexpr uint8_t red() const { return (value >> 16) & 0xFF; }
+        constexpr uint8_t green() const { return (value >> 8) & 0xFF; }
+        constexpr uint8_t blue() const { return value & 0xFF; }
+
+        constexpr bool operator==(Color other) const { return value == other.value; }
+        constexpr bool operator!=(Color other) const { return value != other.value; }
+
+        /**
+         * @brief Scale every channel by amount/256, R and B in one multiply and G in another
+         *
+         * @param amount 0-255, where 255 leaves the color unchanged
+         */
+        constexpr Color scale(uint8_t amount) const
+        {
+            uint32_t factor = amount + 1;
+            return (((value & 0xFF00FF) * factor >> 8) & 0xFF00FF) | (((value & 0x00FF00) * factor >> 8) & 0x00FF00);
+        }
+
+        /**
+         * @brief Integer linear interpolation between two colors, R and B in one multiply and G in another
+         *
+         * @param from the color at amount 0
+         * @param to the color approached as amount goes to 255
+         * @param amount 0-255
+         */
+        static constexpr Color lerp(Color from, Color to, uint8_t amount)
+        {
+            uint32_t inverse = 256 - amount;
+            uint32_t rb = ((from.value & 0xFF00FF) * inverse + (to.value & 0xFF00FF) * amount) >> 8;
+            uint32_t g = ((from.value & 0x00FF00) * inverse + (to.value & 0x00FF00) * amount) >> 8;
+            return (rb & 0xFF00FF) | (g & 0x00FF00);
+        }
+
+        /// The number of steps in the fixed point hue ring
+        static constexpr uint16_t HUE_RING = 6 * 256;
+
+        /**
+         * @brief Divides a product of two 0-255 values by 255, rounding to nearest, without a divide
+         */
+        static constexpr uint32_t div255(uint32_t x)
+        {
+            x += 128;
+            return (x + (x >> 8)) >> 8;
+        }
+
+        /**
+         * @brief Build a Color from fixed point HSV without any floating point math
+         *
+         * The hue ring is split into 6 sectors of 256 steps, so red is 0, green is 512 and blue is 1024.
+         *
+         * @param hue 0-1535, wrapped if larger
+         * @param saturation 0-255
+         * @param value 0-255
+         */
+        static constexpr Color fromHSV(uint16_t hue, uint8_t saturation, uint8_t value)
+        {
+            if (hue >= HUE_RING)
+                hue %= HUE_RING;
+            uint32_t sector = hue >> 8;
+            uint32_t fraction = hue & 0xFF;
+            uint32_t v = value;
+            uint32_t p = div255(v * (255 - saturation));
+            uint32_t q = div255(v * (255 - div255(saturation * fraction)));
+            uint32_t t = div255(v * (255 - div255(saturation * (255 - fraction))));
+            switch (sector)
+            {
+            case 0:
+                return (v << 16) | (t << 8) | p;
+            case 1:
+                return (q << 16) | (v << 8) | p;
+            case 2:
+                return (p << 16) | (v << 8) | t;
+            case 3:
+                return (p << 16) | (q << 8) | v;
+            case 4:
+                return (t << 16) | (p << 8) | v;
+            default:
+                return (v << 16) | (p << 8) | q;
+            }
+        }
+
+        /**
+         * @brief Build a Color from an RGB struct, clamping each channel to 0-255
+         */
+        static constexpr Color fromRGB(RGB rgb)
+        {
+            return Color(clamp(rgb.red), clamp(rgb.green), clamp(rgb.blue));
+        }
+
+        /**
+         * @brief Unpack into an RGB struct
+         */
+        constexpr RGB toRGB() const
+        {
+            return RGB{red(), green(), blue()};
+        }
+
+    private:
+        static constexpr uint8_t clamp(int channel)
+        {
+            if (channel < 0)
+                return 0;
+            if (channel > 255)
+                return 255;
+            return channel;
+        }
+    };
+
+    static_assert(sizeof(Color) == sizeof(uint32_t), "Color must stay packed so a frame can be sent without conversion");
+    static_assert(std::is_trivially_copyable<Color>::value && std::is_standard_layout<Color>::value,
+                  "Color must stay trivially copyable and standard layout");
+};
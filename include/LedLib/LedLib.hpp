@@ -1,31 +1,279 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include "effects/LedEffect.hpp"
+#include "Blend.hpp"
+#include "Color.hpp"
+#include "MpscQueue.hpp"
 #include "main.h"
 namespace LedLib
 {
-    struct RGB
+    /**
+     * @brief A change posted to LedLib from another task, applied at the next frame boundary
+     */
+    struct LedCommand
     {
-        int red;
-        int green;
-        int blue;
+        enum Type : uint8_t
+        {
+            SetActiveEffect,
+            SetPixel,
+            SetAll,
+            Clear,
+            SetParam,
+            SetLayerOpacity,
+            SetSegmentEffect,
+            SetSegmentBrightness
+        };
+        Type type;
+        uint8_t index;  // pixel index for SetPixel, segment index for SetSegmentEffect and SetSegmentBrightness
+        int16_t effect; // effect index for SetActiveEffect, SetParam and SetSegmentEffect, layer index for SetLayerOpacity
+        int32_t param;  // parameter id for SetParam, fade duration for SetActiveEffect
+        uint32_t value; // color for SetPixel/SetAll, value for SetParam, opacity for SetLayerOpacity and SetSegmentBrightness, Easing for SetActiveEffect
     };
 
-    struct HSV
+    /**
+     * @brief One entry in the LedLib layer stack
+     */
+    struct Layer
     {
-        double hue = 0;
-        double saturation = 0;
-        double value = 0;
+        int effect;      // index returned by addEffect
+        BlendMode mode;  // how the layer combines with the layers below
+        uint8_t opacity; // 0-255 strength of the layer
     };
+
+    /**
+     * @brief A named range of a strip running its own effect
+     */
+    struct Segment
+    {
+        const char *name;   // for findSegment, must outlive the LedLib (a string literal is fine)
+        int start;          // index of the first LED
+        int length;         // LEDs in the segment
+        int effect;         // index returned by addEffect, -1 to leave the segment alone
+        uint32_t phase;     // milliseconds the effect runs ahead of the strip, see setSegmentPhase
+        uint8_t brightness; // 0-255 applied on top of the effect
+        uint32_t lead;      // phase not yet fed to the effect through frame.delta
+    };
+
+#ifndef LEDLIB_EFFECT_ARENA_SIZE
+    /// Bytes each LedLib reserves for effects built with emplaceEffect. Override with EXTRA_CXXFLAGS.
+#define LEDLIB_EFFECT_ARENA_SIZE 2048
+#endif
+
+    /**
+     * @brief One physical strip making up part of a LedLib
+     */
+    struct StripPort
+    {
+        uint8_t smartport; // 1-21, or INTERNAL_ADI_PORT for the brain's own ports
+        uint8_t adiport;   // 1-8 representing Triports A-H
+        int length;        // 1-64 LEDs on this port
+    };
+
+    /**
+     * @brief The part of the frame buffer one port shows
+     */
+    struct PortSlice
+    {
+        pros::c::ext_adi_led_t port;
+        int offset; // index of the first LED on this port
+        int length; // LEDs on this port
+    };
+
+    /**
+     * @brief A typed reference to an effect built inside a LedLib by emplaceEffect
+     */
+    template <typename T>
+    struct EffectHandle
+    {
+        int index = -1;       // index for setActiveEffect, addLayer and postParam
+        T *effect = nullptr;  // the effect, owned by the LedLib
+
+        explicit operator bool() const { return this->effect != nullptr; }
+        T *operator->() const { return this->effect; }
+    };
+
     class LedLib
     {
     public:
-        pros::ADILED strip;
+        pros::c::ext_adi_led_t port;
         int addEffect(LedEffect *customEffect);
-        void updateEffects();
         void setActiveEffect(int active);
+
+        /// The most effects one LedLib can hold
+        static constexpr int MAX_EFFECTS = 16;
+
+        /**
+         * @brief Construct an effect inside this LedLib's fixed size arena and add it
+         *
+         * The effect lives as long as the LedLib, so unlike addEffect there is no pointer to keep alive, and the
+         * heap is never touched. Fails and returns an empty handle if the arena or MAX_EFFECTS is exhausted.
+         *
+         * @tparam T the effect type
+         * @param args forwarded to T's constructor
+         * @return A handle holding the effect index and a typed pointer
+         */
+        template <typename T, typename... Args>
+        EffectHandle<T> emplaceEffect(Args &&...args)
+        {
+            static_assert(std::is_base_of<LedEffect, T>::value, "emplaceEffect needs a LedEffect");
+            static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned effects are not supported");
+            size_t offset = (this->arenaOffset + alignof(T) - 1) & ~(alignof(T) - 1);
+            if (offset + sizeof(T) > LEDLIB_EFFECT_ARENA_SIZE || this->effectCount >= MAX_EFFECTS)
+            {
+                effectArenaFull(sizeof(T));
+                return EffectHandle<T>();
+            }
+            T *effect = new (this->arena + offset) T(std::forward<Args>(args)...);
+            this->arenaOffset = offset + sizeof(T);
+            this->owned[this->effectCount] = true;
+            EffectHandle<T> handle;
+            handle.index = this->addEffect(effect);
+            handle.effect = effect;
+            return handle;
+        }
+
+        /**
+         * @brief Bytes of the effect arena in use
+         */
+        size_t arenaUsed() const;
+
+        /**
+         * @brief Total bytes in the effect arena
+         */
+        static constexpr size_t arenaCapacity()
+        {
+            return LEDLIB_EFFECT_ARENA_SIZE;
+        }
+
+        ~LedLib();
+
+        /**
+         * @brief Crossfade from the current effect to another
+         *
+         * Both effects render every frame until the fade finishes, then the outgoing effect stops being
+         * updated. Starting a new transition mid-fade cuts the old outgoing effect and fades from the
+         * current target instead. While any layer or segment exists the switch is instant, and adding one
+         * ends a fade in progress.
+         *
+         * @param active the index returned by addEffect
+         * @param duration length of the fade in milliseconds, 0 switches instantly
+         * @param curve the shape of the fade
+         */
+        void setActiveEffect(int active, uint32_t duration, Easing curve = Easing::Linear);
+
+        /**
+         * @brief Whether a crossfade started by setActiveEffect is still running
+         */
+        bool isTransitioning() const;
+
+        /**
+         * @brief Change the number of LEDs driven, then call onResize on every effect
+         *
+         * Allocates, so call it during setup rather than while rendering. On a strip spanning several ports only the
+         * last port changes length, and it is clamped to MAX_PORT_LENGTH.
+         *
+         * @param length 1-64 representing the length of the LEDs
+         */
+        void resize(int length);
+
+        /**
+         * @brief Render one frame of the active effect and commit it, timed by the clock
+         */
+        void updateEffects();
+
+        /**
+         * @brief Render one frame of the active effect into the frame buffer without committing it
+         *
+         * For drivers like LedManager that schedule commits themselves. updateEffects() is render() then commit().
+         */
+        void render();
+
+        /**
+         * @brief Render one frame with an explicit frame context without committing it
+         *
+         * @param frame the timing the effect sees
+         */
+        void render(const FrameContext &frame);
+
+        /**
+         * @brief Render one frame of the active effect with an explicit frame context and commit it
+         *
+         * Useful for deterministic replay or tests. Does not advance the internal frame counter.
+         *
+         * @param frame the timing the effect sees
+         */
+        void updateEffects(const FrameContext &frame);
+
+        /**
+         * @brief Replace the clock that timestamps frames
+         *
+         * @param clock a function returning milliseconds, pros::millis by default
+         */
+        void setClock(uint32_t (*clock)());
         int size;
 
+        /**
+         * @brief The frame buffer effects draw into
+         *
+         * Color is packed as 0xRRGGBB, so this is handed to the strip as a uint32_t array with no conversion.
+         * Nothing here reaches the strip until commit() is called. updateEffects() commits once per frame.
+         */
+        std::vector<Color> buffer;
+
+        /**
+         * @brief Counters describing how much traffic commit() actually put on the ADI bus
+         */
+        struct CommitStats
+        {
+            uint32_t commits = 0;    // commits that wrote to the strip
+            uint32_t skipped = 0;    // commits skipped because nothing changed
+            uint32_t failed = 0;     // commits the strip rejected, retried on the next commit
+            uint32_t pixelsSent = 0; // pixels written across all commits
+            uint32_t lastMicros = 0; // time the last write took
+            uint32_t maxMicros = 0;  // slowest write
+            uint64_t totalMicros = 0; // time spent in all writes, divide by commits for the average
+        };
+        CommitStats stats;
+
+        /**
+         * @brief Counters describing how well the render task kept up with its frame rate
+         */
+        struct FrameStats
+        {
+            uint32_t frames = 0;  // frames rendered by the render task
+            uint32_t late = 0;    // frames that finished after their deadline
+            uint32_t dropped = 0; // frame slots skipped to catch back up
+            uint32_t overBudget = 0; // effect updates slower than the effect's renderBudget()
+
+            /**
+             * @brief Count a finished frame and sleep until the next one, skipping the slots it overran
+             *
+             * @param wake the start of the frame, advanced to the start of the next one
+             * @param period milliseconds per frame
+             */
+            void endFrame(uint32_t &wake, uint32_t period);
+        };
+        FrameStats frameStats;
+
+        /// The least time in microseconds an effect's budget is scaled down to, covering the fixed cost of timing it
+        static constexpr uint32_t MIN_RENDER_BUDGET = 20;
+
+        /**
+         * @brief The range of pixels changed since the last commit, as [dirtyStart, dirtyEnd)
+         *
+         * The range is empty when dirtyStart >= dirtyEnd.
+         */
+        int dirtyStart;
+        int dirtyEnd;
+
         /**
          * @brief Construct a new Led object
          *
@@ -55,6 +303,28 @@ namespace LedLib
          */
         LedLib(uint8_t smartport, uint8_t adiport, int length);
 
+        /**
+         * @brief Construct one logical strip from several physical strips, chained end to end
+         *
+         * Effects see a single strip as long as all the ports together, e.g. {{INTERNAL_ADI_PORT, 1, 64},
+         * {INTERNAL_ADI_PORT, 2, 64}, {14, 1, 64}} is one 192 LED strip. Each port is sent its own slice of the
+         * frame buffer directly, with no copy.
+         *
+         * @param ports the physical strips in order, at most MAX_PORTS, each 1-64 LEDs
+         */
+        LedLib(std::initializer_list<StripPort> ports);
+
+        /// The most physical strips one LedLib can span
+        static constexpr int MAX_PORTS = 4;
+        /// The most LEDs one ADI port drives. Longer ports are clamped, which also keeps every index in a uint8_t.
+        static constexpr int MAX_PORT_LENGTH = 64;
+
+        /**
+         * @brief The physical strips this LedLib sends to, in order. port is the first one's handle.
+         */
+        std::array<PortSlice, MAX_PORTS> ports;
+        int portCount = 0;
+
         /**
          * @brief Set all leds to a given RGB color
          *
@@ -69,6 +339,13 @@ namespace LedLib
          */
         void setAll(HSV hsv);
 
+        /**
+         * @brief Set all leds to a given color
+         *
+         * @param color a packed Color or 0xRRGGBB literal
+         */
+        void setAll(Color color);
+
         /**
          * @brief Set all LEDs to a specified color loopy style
          *
@@ -103,6 +380,332 @@ namespace LedLib
          */
         void setPixel(HSV hsv, uint8_t index);
 
+        /**
+         * @brief Set a given pixel to a specified color
+         *
+         * @param color a packed Color or 0xRRGGBB literal
+         * @param index the index of the LED
+         */
+        void setPixel(Color color, uint8_t index);
+
+        /**
+         * @brief Copy a run of colors into the frame buffer
+         *
+         * Pixels past the end of the strip are ignored.
+         *
+         * @param colors the colors to copy
+         * @param count the number of colors
+         * @param start the index of the first LED to write
+         */
+        void setPixels(const Color *colors, int count, int start = 0);
+
+        /**
+         * @brief Fill a run of pixels from a kernel called with each index
+         *
+         * A shade() over the run, so clipping, masking and change tracking are the same as for shaders, and a kernel
+         * the compiler can see (a lambda or a PixelEffect's pixel()) is inlined with no call per pixel.
+         *
+         * @param kernel called as kernel(int index) and returning a Color
+         * @param start the index of the first LED to write
+         * @param count the number of LEDs, -1 for the rest of the strip
+         */
+        template <typename Kernel>
+        void generate(Kernel &&kernel, int start = 0, int count = -1)
+        {
+            this->shade([&kernel, start](int index, uint16_t position, uint32_t time)
+                        { return kernel(start + index); },
+                        0, start, count);
+        }
+
+        /**
+         * @brief Run a per-pixel shader over a window of the strip
+         *
+         * The engine owns the loop: the window is clipped to the strip, masked pixels are skipped without calling
+         * the shader, and only changed pixels are written. The shader never sees an index it could write out of
+         * bounds with, and is inlined into the loop when its type is visible.
+         *
+         * @param shader called as shader(int index, uint16_t position, uint32_t time) and returning a Color.
+         *        index counts from the start of the window, position runs from 0 at its first LED to 65535 at its last.
+         * @param time passed through to the shader, normally FrameContext::time
+         * @param start the index of the first LED in the window
+         * @param count the number of LEDs in the window, -1 for the rest of the strip
+         */
+        template <typename Shader>
+        void shade(Shader &&shader, uint32_t time, int start = 0, int count = -1)
+        {
+            if (count < 0)
+                count = this->size - start;
+            if (count <= 0)
+                return;
+            // Position in 16.16 fixed point, stepped so the last LED of the window lands on 65535
+            uint32_t step = count > 1 ? 0xFFFFFFFFu / static_cast<uint32_t>(count - 1) : 0;
+            uint32_t position = 0;
+            int begin = start < 0 ? 0 : start;
+            int end = start + count > this->size ? this->size : start + count;
+            position += step * static_cast<uint32_t>(begin - start);
+            Color *pixels = this->target;
+            const uint8_t *masked = nullptr;
+            int maskEnd = 0;
+            if (this->masking())
+            {
+                masked = this->mask.data() + this->targetOffset;
+                maskEnd = static_cast<int>(this->mask.size()) - this->targetOffset;
+            }
+            int first = end;
+            int last = begin;
+            for (int index = begin; index < end; index++, position += step)
+            {
+                if (masked && index < maskEnd && !masked[index])
+                    continue;
+                Color color = shader(index - start, static_cast<uint16_t>(position >> 16), time);
+                if (pixels[index] != color)
+                {
+                    pixels[index] = color;
+                    if (index < first)
+                        first = index;
+                    last = index + 1;
+                }
+            }
+            if (first < last)
+                this->markDirty(pixels, first, last);
+        }
+
+        /**
+         * @brief LEDs the render pipeline may not draw
+         *
+         * While a frame renders, every write into the frame buffer (effects, layers, transitions and segments alike)
+         * skips LEDs whose entry is 0, so they keep whatever was set directly, e.g. a status LED set with setPixel.
+         * LEDs past the end of the mask, and every LED when it is empty (the default), are drawn.
+         */
+        std::vector<uint8_t> mask;
+
+        /**
+         * @brief Get the color of a given pixel in the frame buffer
+         *
+         * @param index the index of the LED
+         * @return The color, or off if index is out of range
+         */
+        Color getPixel(uint8_t index) const;
+
+        /**
+         * @brief Set every pixel in the frame buffer to off
+         */
+        void clear();
+
+        /**
+         * @brief Push the frame buffer to the strip in a single write
+         *
+         * If the write fails the changed range is kept, so the next commit sends it again.
+         *
+         * @return PROS_SUCCESS if successful, PROS_ERR if not
+         */
+        int32_t commit();
+
+        /**
+         * @brief Mark the whole frame buffer as changed so the next commit resends every pixel
+         *
+         * Use this if the strip was unplugged or power cycled and no longer matches the buffer.
+         */
+        void invalidate();
+
+        /**
+         * @brief Reset the counters in stats and frameStats to zero
+         */
+        void resetStats();
+
+        /**
+         * @brief Start a task that calls updateEffects() at a fixed frame rate
+         *
+         * Frames are paced with task_delay_until, so the period does not drift with render time.
+         * Call this from initialize(); the task outlives competition mode changes. Calling it while
+         * already running does nothing. Calls prepare() first, so the task never allocates.
+         *
+         * @param fps 1-1000 frames per second. The period is rounded down to whole milliseconds.
+         * @param priority the priority of the render task
+         */
+        void start(uint32_t fps = 60, uint32_t priority = TASK_PRIORITY_DEFAULT - 1);
+
+        /**
+         * @brief Allocate the scratch frames fades, layers and segments render through, if not done already
+         *
+         * start() and LedManager::start() call this, so a fade posted to a running strip doesn't allocate on the
+         * render task. Call it yourself before rendering from your own task.
+         */
+        void prepare();
+
+        /**
+         * @brief Stop the render task, waiting for the frame in progress to finish
+         *
+         * Must not be called from inside an effect.
+         */
+        void stop();
+
+        /**
+         * @brief Whether the render task is running
+         */
+        bool isRunning() const;
+
+        /// Commands
+
+        /**
+         * @brief Queue a command to be applied by the render task at the start of the next frame
+         *
+         * Safe to call from any task. Never blocks and never allocates.
+         *
+         * @param command the command to queue
+         * @return false if the queue is full and the command was dropped
+         */
+        bool post(const LedCommand &command);
+
+        /**
+         * @brief Queue a setActiveEffect call. Safe to call from any task.
+         */
+        bool postActiveEffect(int active);
+
+        /**
+         * @brief Queue a crossfading setActiveEffect call. Safe to call from any task.
+         */
+        bool postActiveEffect(int active, uint32_t duration, Easing curve = Easing::Linear);
+
+        /**
+         * @brief Queue a setPixel call. Safe to call from any task.
+         */
+        bool postPixel(Color color, uint8_t index);
+
+        /**
+         * @brief Queue a setAll call. Safe to call from any task.
+         */
+        bool postAll(Color color);
+
+        /**
+         * @brief Queue a LedEffect::setParam call on the given effect. Safe to call from any task.
+         */
+        bool postParam(int effect, int param, int32_t value);
+
+        /**
+         * @brief Queue a setLayerOpacity call. Safe to call from any task.
+         */
+        bool postLayerOpacity(int layer, uint8_t opacity);
+
+        /// Layers
+
+        /// The most layers the compositor will stack
+        static constexpr int MAX_LAYERS = 8;
+
+        /**
+         * @brief Stack an effect on top of the existing layers
+         *
+         * Once any layer exists, updateEffects() composites the layer stack instead of rendering activeEffect,
+         * which is deactivated until clearLayers().
+         * Each layer renders into a scratch buffer that starts black, then is blended onto the layers below in
+         * one pass. Black pixels are transparent under Add, Screen and Max. The first call allocates two
+         * scratch frames; no further memory is used however many layers are added.
+         *
+         * @param effect the index returned by addEffect
+         * @param mode how the layer combines with the layers below
+         * @param opacity 0-255 strength of the layer
+         * @return The index of the new layer, or -1 if MAX_LAYERS is reached
+         */
+        int addLayer(int effect, BlendMode mode = BlendMode::Normal, uint8_t opacity = 255);
+
+        /**
+         * @brief Change the strength of a layer. 0 skips rendering it entirely.
+         */
+        void setLayerOpacity(int layer, uint8_t opacity);
+
+        /**
+         * @brief Change how a layer combines with the layers below
+         */
+        void setLayerMode(int layer, BlendMode mode);
+
+        /**
+         * @brief Remove every layer, going back to rendering activeEffect
+         */
+        void clearLayers();
+
+        std::array<Layer, MAX_LAYERS> layers;
+        int layerCount = 0;
+
+        /// Segments
+
+        /// The most segments one strip can be split into
+        static constexpr int MAX_SEGMENTS = 8;
+
+        /**
+         * @brief Split off a range of the strip to run its own effect
+         *
+         * Once any segment exists, updateEffects() renders every segment instead of the layers or activeEffect,
+         * which are deactivated until clearSegments().
+         * Each segment's effect sees a strip exactly as long as the segment and draws straight into its part of the
+         * frame buffer, so the whole strip still goes out in one commit. LEDs outside every segment are left as they
+         * are. Give every segment its own effect instance, since effects keep per-strip state.
+         *
+         * @param name a name for findSegment, must outlive the LedLib (a string literal is fine)
+         * @param start the index of the first LED
+         * @param length the number of LEDs
+         * @param effect the index returned by addEffect, -1 for none yet
+         * @return The index of the new segment, or -1 if MAX_SEGMENTS is reached
+         */
+        int addSegment(const char *name, int start, int length, int effect = -1);
+
+        /**
+         * @brief Look a segment up by name
+         *
+         * @return The index of the segment, or -1 if there is none with that name
+         */
+        int findSegment(const char *name) const;
+
+        /**
+         * @brief Change the effect a segment runs, -1 for none
+         */
+        void setSegmentEffect(int segment, int effect);
+
+        /**
+         * @brief Run a segment's effect ahead of the strip, e.g. so two arms running the same effect are out of step
+         *
+         * The phase is added to every frame.time the effect sees, and the next frame's delta is stretched by any
+         * increase, so effects that animate from either end up phase milliseconds ahead. A delta-driven effect
+         * can't be wound back, so lowering the phase only moves time-driven effects back.
+         *
+         * @param phase milliseconds to run ahead
+         */
+        void setSegmentPhase(int segment, uint32_t phase);
+
+        /**
+         * @brief Dim a segment
+         *
+         * The effect renders into a scratch copy of the segment, which is scaled into the frame buffer, so the
+         * effect never sees its own dimmed output.
+         *
+         * @param brightness 0-255, where 255 is the effect's own output
+         */
+        void setSegmentBrightness(int segment, uint8_t brightness);
+
+        /**
+         * @brief Remove every segment, going back to rendering the layers or activeEffect
+         */
+        void clearSegments();
+
+        /**
+         * @brief Queue a setSegmentEffect call. Safe to call from any task.
+         */
+        bool postSegmentEffect(int segment, int effect);
+
+        /**
+         * @brief Queue a setSegmentBrightness call. Safe to call from any task.
+         */
+        bool postSegmentBrightness(int segment, uint8_t brightness);
+
+        std::array<Segment, MAX_SEGMENTS> segments;
+        int segmentCount = 0;
+
+        /**
+         * @brief Apply every queued command. updateEffects() does this before rendering.
+         *
+         * Must only be called from the task that renders.
+         */
+        void processCommands();
+
         /// Static Functions
 
         /**
@@ -130,6 +733,53 @@ namespace LedLib
          */
         static RGB HSVtoRGB(HSV hsv);
 
+        /**
+         * @brief Converts fixed point HSV to a uint32_t color without any floating point math
+         *
+         * The hue ring is split into 6 sectors of 256 steps, so red is 0, green is 512 and blue is 1024.
+         *
+         * @param hue 0-1535, wrapped if larger
+         * @param saturation 0-255
+         * @param value 0-255
+         * @return A uint32_t color
+         */
+        static constexpr uint32_t HSVtoUINT32(uint16_t hue, uint8_t saturation, uint8_t value)
+        {
+            return Color::fromHSV(hue, saturation, value).value;
+        }
+
+        /**
+         * @brief Look up a fully saturated rainbow color from Tables::rainbow
+         *
+         * @param hue 0-255 around the color wheel
+         * @return A Color
+         */
+        static Color rainbow(uint8_t hue);
+
+        /**
+         * @brief Gamma correct each channel of a color through Tables::gamma
+         *
+         * @param color the color to correct
+         * @return The corrected color
+         */
+        static Color gammaCorrect(Color color);
+
+        /**
+         * @brief Table driven sine
+         *
+         * @param theta 0-255 representing one full turn
+         * @return 1-255, centered on 128
+         */
+        static uint8_t sin8(uint8_t theta);
+
+        /**
+         * @brief Table driven cosine
+         *
+         * @param theta 0-255 representing one full turn
+         * @return 1-255, centered on 128
+         */
+        static uint8_t cos8(uint8_t theta);
+
         /**
          * @brief uint32_t Color to RGB
          *
@@ -163,7 +813,73 @@ namespace LedLib
         static uint32_t HSVtoUINT32(HSV hsv);
 
         
-        std::vector<LedEffect *> effects;
+        std::array<LedEffect *, MAX_EFFECTS> effects;
+        int effectCount = 0;
         int activeEffect;
+
+    private:
+        static void effectArenaFull(size_t requested);
+        static uint8_t percentTo255(double percent);
+        void addPort(pros::c::ext_adi_led_t handle, int length);
+        void writePixel(int index, Color color);
+        /// Whether writes to target skip masked LEDs: only while rendering, and only into the frame buffer
+        bool masking() const
+        {
+            return this->rendering && !this->mask.empty() && this->target == this->buffer.data() + this->targetOffset;
+        }
+        void markDirty(const Color *pixels, int first, int last)
+        {
+            // Scratch buffers are never committed, so only the frame buffer tracks changes
+            if (pixels != this->buffer.data() + this->targetOffset)
+                return;
+            first += this->targetOffset;
+            last += this->targetOffset;
+            if (first < this->dirtyStart)
+                this->dirtyStart = first;
+            if (last > this->dirtyEnd)
+                this->dirtyEnd = last;
+        }
+        void fill(Color color);
+        void renderLoop();
+        void renderLayers(const FrameContext &frame);
+        void renderSegments(const FrameContext &frame);
+        void renderInto(Color *destination, int effect, const FrameContext &frame);
+        void runEffect(int effect, const FrameContext &frame);
+        void renderTransition(const FrameContext &frame);
+        bool validEffect(int effect) const;
+        void allocateScratch();
+        void cancelTransition();
+        void setBaseActive(bool active);
+
+        int transitionFrom = -1;
+        bool transitionStarted = false;
+        uint32_t transitionStart = 0;
+        uint32_t transitionDuration = 0;
+        Easing transitionCurve = Easing::Linear;
+
+        alignas(std::max_align_t) unsigned char arena[LEDLIB_EFFECT_ARENA_SIZE];
+        size_t arenaOffset = 0;
+        std::array<bool, MAX_EFFECTS> owned{};
+
+        /// Where setPixel and friends write. The frame buffer, except while a layer renders into scratch.
+        Color *target;
+        /// Where index 0 of target sits in the frame buffer while a segment renders, 0 otherwise
+        int targetOffset = 0;
+        /// Set while render() draws a frame, when mask applies
+        bool rendering = false;
+        /// Set while commits are failing, so the failure is only logged once
+        bool commitFailing = false;
+        /// Set while an effect is running over its budget, so each overrun is only logged once
+        std::array<bool, MAX_EFFECTS> overrunning{};
+        std::vector<Color> composeBuffer;
+        std::vector<Color> layerBuffer;
+
+        uint32_t (*clock)() = pros::millis;
+        uint32_t frameNumber = 0;
+        uint32_t lastFrameTime = 0;
+        MpscQueue<LedCommand, 32> commands;
+        std::unique_ptr<pros::Task> renderTask;
+        std::atomic<bool> running{false};
+        uint32_t framePeriod = 16;
     };
 };
\ No newline at end of file
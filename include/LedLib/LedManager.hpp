@@ -0,0 +1,105 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <memory>
+#include "LedLib.hpp"
+#include "main.h"
+namespace LedLib
+{
+    /**
+     * @brief How LedManager spaces out the ADI writes of its strips within a frame
+     */
+    enum class CommitMode
+    {
+        Batch,   // render every strip, then commit them back to back
+        Stagger  // give each strip its own slot in the frame, rendering and committing it there
+    };
+
+    /**
+     * @brief Renders and commits several strips from one task
+     *
+     * Instead of every strip running its own render task, add them all to one manager and start it. Each frame the
+     * manager renders every strip and schedules the ADI writes itself. In Stagger mode the writes are spread evenly
+     * across the frame, so strips sharing a 3-wire expander don't all hit its bus at the same moment.
+     * Each strip's commit latency is recorded in its own LedLib::stats (lastMicros, maxMicros, totalMicros).
+     *
+     * Strips added here must not also be started with LedLib::start. post* functions still work as usual.
+     */
+    class LedManager
+    {
+    public:
+        /// The most strips one manager can drive
+        static constexpr int MAX_STRIPS = 8;
+
+        LedManager() = default;
+        LedManager(const LedManager &) = delete;
+        LedManager &operator=(const LedManager &) = delete;
+        ~LedManager();
+
+        /**
+         * @brief Add a strip to be driven by this manager
+         *
+         * The strip must outlive the manager or be removed first. Must not be called while the manager is running.
+         *
+         * @param strip the strip
+         * @return The index of the strip, or -1 if MAX_STRIPS are already added or the manager is running
+         */
+        int addStrip(LedLib *strip);
+
+        /**
+         * @brief The number of strips added
+         */
+        int stripCount() const;
+
+        /**
+         * @brief Get a strip by the index returned by addStrip
+         *
+         * @return The strip, or nullptr if index is out of range
+         */
+        LedLib *strip(int index) const;
+
+        /**
+         * @brief Render every strip once and commit them according to the commit mode, without any waiting
+         *
+         * For driving the strips from your own loop instead of start().
+         */
+        void update();
+
+        /**
+         * @brief Start a task that renders and commits every strip at a fixed frame rate
+         *
+         * @param fps 1-1000 frames per second. The period is rounded down to whole milliseconds.
+         * @param mode how the commits of the strips are spaced out
+         * @param priority the priority of the render task
+         */
+        void start(uint32_t fps = 60, CommitMode mode = CommitMode::Stagger, uint32_t priority = TASK_PRIORITY_DEFAULT - 1);
+
+        /**
+         * @brief Stop the render task, waiting for the frame in progress to finish
+         */
+        void stop();
+
+        /**
+         * @brief Whether the render task is running
+         */
+        bool isRunning() const;
+
+        /**
+         * @brief Reset the frame counters here and the counters of every strip
+         */
+        void resetStats();
+
+        /// Counters for the manager's render task, as in LedLib::frameStats
+        LedLib::FrameStats frameStats;
+
+    private:
+        void renderLoop();
+
+        std::array<LedLib *, MAX_STRIPS> strips{};
+        int count = 0;
+        CommitMode mode = CommitMode::Stagger;
+        uint32_t framePeriod = 16;
+        std::unique_ptr<pros::Task> renderTask;
+        std::atomic<bool> running{false};
+    };
+};
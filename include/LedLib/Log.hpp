@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "main.h"
+
+/**
+ * Compile time log levels. Set LEDLIB_LOG_LEVEL with EXTRA_CXXFLAGS in the Makefile, e.g.
+ * EXTRA_CXXFLAGS=-DLEDLIB_LOG_LEVEL=LEDLIB_LOG_LEVEL_DEBUG
+ *
+ * Any LEDLIB_LOG_* call above the configured level expands to nothing, arguments included.
+ */
+#define LEDLIB_LOG_LEVEL_NONE 0
+#define LEDLIB_LOG_LEVEL_ERROR 1
+#define LEDLIB_LOG_LEVEL_WARN 2
+#define LEDLIB_LOG_LEVEL_INFO 3
+#define LEDLIB_LOG_LEVEL_DEBUG 4
+
+#ifndef LEDLIB_LOG_LEVEL
+#define LEDLIB_LOG_LEVEL LEDLIB_LOG_LEVEL_WARN
+#endif
+
+#if LEDLIB_LOG_LEVEL >= LEDLIB_LOG_LEVEL_ERROR
+#define LEDLIB_LOG_ERROR(...) ::LedLib::Log::write(::LedLib::Log::Error, __VA_ARGS__)
+#else
+#define LEDLIB_LOG_ERROR(...) ((void)0)
+#endif
+
+#if LEDLIB_LOG_LEVEL >= LEDLIB_LOG_LEVEL_WARN
+#define LEDLIB_LOG_WARN(...) ::LedLib::Log::write(::LedLib::Log::Warn, __VA_ARGS__)
+#else
+#define LEDLIB_LOG_WARN(...) ((void)0)
+#endif
+
+#if LEDLIB_LOG_LEVEL >= LEDLIB_LOG_LEVEL_INFO
+#define LEDLIB_LOG_INFO(...) ::LedLib::Log::write(::LedLib::Log::Info, __VA_ARGS__)
+#else
+#define LEDLIB_LOG_INFO(...) ((void)0)
+#endif
+
+#if LEDLIB_LOG_LEVEL >= LEDLIB_LOG_LEVEL_DEBUG
+#define LEDLIB_LOG_DEBUG(...) ::LedLib::Log::write(::LedLib::Log::Debug, __VA_ARGS__)
+#else
+#define LEDLIB_LOG_DEBUG(...) ((void)0)
+#endif
+
+namespace LedLib
+{
+    /**
+     * @brief Non-blocking diagnostics for code that runs every frame
+     *
+     * write() formats into a fixed size entry and pushes it onto a lock-free queue, so the caller never waits on
+     * serial output. A low priority task started by start() prints the entries. When the queue is full the
+     * message is dropped and counted instead.
+     *
+     * Use the LEDLIB_LOG_* macros rather than calling write() directly so disabled levels compile away.
+     */
+    class Log
+    {
+    public:
+        enum Level : uint8_t
+        {
+            Error = LEDLIB_LOG_LEVEL_ERROR,
+            Warn = LEDLIB_LOG_LEVEL_WARN,
+            Info = LEDLIB_LOG_LEVEL_INFO,
+            Debug = LEDLIB_LOG_LEVEL_DEBUG
+        };
+
+        /**
+         * @brief Format a message and queue it for the flush task. Safe to call from any task.
+         *
+         * @param level the severity of the message
+         * @param format a printf style format string, truncated to fit one entry
+         */
+        static void write(Level level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+        /**
+         * @brief Start the task that prints queued messages. Calling it again does nothing.
+         *
+         * LedLib::start() calls this, so it is only needed when rendering from your own loop.
+         *
+         * @param priority the priority of the flush task, keep it below anything time critical
+         */
+        static void start(uint32_t priority = TASK_PRIORITY_MIN);
+
+        /**
+         * @brief Print every queued message now
+         *
+         * Only call this when the flush task isn't running, since the queue has a single reader.
+         */
+        static void flush();
+
+        /**
+         * @brief The number of messages dropped because the queue was full
+         */
+        static uint32_t dropped();
+    };
+};
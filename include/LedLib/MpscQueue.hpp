@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+namespace LedLib
+{
+    /**
+     * @brief A bounded, allocation-free queue that any number of tasks can push to and one task pops from
+     *
+     * Every slot carries a sequence number, so producers claim a slot with a single compare-and-swap and never
+     * block each other or the consumer. push() fails instead of waiting when the queue is full.
+     *
+     * @note Based on Dmitry Vyukov's bounded MPMC queue: https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+     *
+     * @tparam T a trivially copyable item type
+     * @tparam Capacity the number of slots, must be a power of two
+     */
+    template <typename T, size_t Capacity>
+    class MpscQueue
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        MpscQueue()
+        {
+            for (size_t i = 0; i < Capacity; i++)
+                this->cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MpscQueue(const MpscQueue &) = delete;
+        MpscQueue &operator=(const MpscQueue &) = delete;
+
+        /**
+         * @brief Add an item to the back of the queue. Safe to call from any task.
+         *
+         * @param item the item to copy in
+         * @return false if the queue is full and the item was not added
+         */
+        bool push(const T &item)
+        {
+            size_t pos = this->enqueuePos.load(std::memory_order_relaxed);
+            while (true)
+            {
+                Cell &cell = this->cells[pos & (Capacity - 1)];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    // The slot is free; try to claim it. On failure pos is reloaded with the current value.
+                    if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.data = item;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // The slot still holds an item the consumer has not popped yet
+                    return false;
+                }
+                else
+                {
+                    pos = this->enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Remove the item at the front of the queue. Only one task may pop.
+         *
+         * @param item receives the popped item
+         * @return false if the queue was empty
+         */
+        bool pop(T &item)
+        {
+            size_t pos = this->dequeuePos.load(std::memory_order_relaxed);
+            Cell &cell = this->cells[pos & (Capacity - 1)];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1) < 0)
+                return false;
+            item = cell.data;
+            cell.sequence.store(pos + Capacity, std::memory_order_release);
+            this->dequeuePos.store(pos + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+
+        Cell cells[Capacity];
+        std::atomic<size_t> enqueuePos{0};
+        std::atomic<size_t> dequeuePos{0};
+    };
+};
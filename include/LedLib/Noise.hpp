@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+namespace LedLib
+{
+    /**
+     * @brief Integer gradient (Perlin) noise in 1, 2 and 3 dimensions
+     *
+     * Coordinates are 8.8 fixed point: the high bits pick a lattice cell and the low 8 bits are the position inside
+     * it, so stepping a coordinate by 256 moves one cell. The lattice repeats every 256 cells, which is exactly
+     * where a uint32_t coordinate can usefully wrap, so animating a coordinate by time never jumps.
+     *
+     * Everything is table driven integer math: a 256 entry permutation, a 256 entry fade curve and additions and
+     * multiplies in int32_t. No floating point is used.
+     */
+    namespace Noise
+    {
+        /**
+         * @brief 1D noise
+         *
+         * @param x 8.8 fixed point coordinate
+         * @return -256 to 256, 0 on every lattice point
+         */
+        int16_t perlin(uint32_t x);
+
+        /**
+         * @brief 2D noise
+         *
+         * @param x 8.8 fixed point coordinate
+         * @param y 8.8 fixed point coordinate
+         * @return about -256 to 256, 0 on every lattice point
+         */
+        int16_t perlin(uint32_t x, uint32_t y);
+
+        /**
+         * @brief 3D noise
+         *
+         * @param x 8.8 fixed point coordinate
+         * @param y 8.8 fixed point coordinate
+         * @param z 8.8 fixed point coordinate
+         * @return about -256 to 256, 0 on every lattice point
+         */
+        int16_t perlin(uint32_t x, uint32_t y, uint32_t z);
+
+        /**
+         * @brief Map a noise value to 0-255, centered on 128
+         */
+        constexpr uint8_t toUnsigned(int16_t noise)
+        {
+            int32_t value = (noise >> 1) + 128;
+            return value < 0 ? 0 : (value > 255 ? 255 : value);
+        }
+
+        /// 1D noise mapped to 0-255
+        inline uint8_t noise8(uint32_t x) { return toUnsigned(perlin(x)); }
+
+        /// 2D noise mapped to 0-255
+        inline uint8_t noise8(uint32_t x, uint32_t y) { return toUnsigned(perlin(x, y)); }
+
+        /// 3D noise mapped to 0-255
+        inline uint8_t noise8(uint32_t x, uint32_t y, uint32_t z) { return toUnsigned(perlin(x, y, z)); }
+    }
+};
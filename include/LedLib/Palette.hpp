@@ -0,0 +1,114 @@
+#pragma once
+#include "Color.hpp"
+namespace LedLib
+{
+    /**
+     * @brief A compact 16 color palette, meant to be expanded into a Palette256 before rendering
+     */
+    struct Palette16
+    {
+        Color entries[16];
+    };
+
+    /**
+     * @brief A 256 entry (1 KB) palette that effects index with an 8 bit position
+     *
+     * All of the interpolation happens when the palette is loaded, so looking a color up is a single array read.
+     * Rebuild it at runtime (e.g. to switch team colors) with load() or loadGradient().
+     */
+    class Palette256
+    {
+    public:
+        Color entries[256];
+
+        /**
+         * @brief Construct an all black palette
+         */
+        Palette256();
+
+        /**
+         * @brief Construct by expanding a 16 color palette
+         *
+         * @param palette the palette to expand
+         * @param wrap blend the last entry back into the first, for palettes that loop like a rainbow
+         */
+        explicit Palette256(const Palette16 &palette, bool wrap = true);
+
+        /**
+         * @brief Expand a 16 color palette, interpolating 16 steps between neighbouring entries
+         *
+         * @param palette the palette to expand
+         * @param wrap blend the last entry back into the first, for palettes that loop like a rainbow.
+         *             Otherwise the 16 entries are stretched so the last one lands on index 255.
+         */
+        void load(const Palette16 &palette, bool wrap = true);
+
+        /**
+         * @brief Fill the palette with a straight RGB gradient
+         *
+         * @param start the color at index 0
+         * @param end the color at index 255
+         */
+        void loadGradient(Color start, Color end);
+
+        /**
+         * @brief Fill the palette with a gradient that travels around the hue wheel
+         *
+         * @param start the color at index 0
+         * @param end the color at index 255
+         *
+         * @note Uses LedLib::lerpHSV, so this is slow and meant for setup, not per frame
+         */
+        void loadGradient(HSV start, HSV end);
+
+        Color operator[](uint8_t index) const
+        {
+            return this->entries[index];
+        }
+    };
+
+    /**
+     * @brief Look up a palette color and scale it to a brightness
+     *
+     * @param palette the palette to read from
+     * @param index 0-255 position in the palette
+     * @param brightness 0-255, where 255 is the palette color unchanged
+     */
+    inline Color colorFromPalette(const Palette256 &palette, uint8_t index, uint8_t brightness = 255)
+    {
+        Color color = palette.entries[index];
+        if (brightness == 255)
+            return color;
+        return color.scale(brightness);
+    }
+
+    /// Ready made 16 color palettes
+    namespace Palettes
+    {
+        inline constexpr Palette16 Rainbow = {{0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00,
+                                               0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+                                               0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5,
+                                               0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B}};
+
+        /// Black through red and yellow to white. Load without wrap.
+        inline constexpr Palette16 Heat = {{0x000000, 0x330000, 0x660000, 0x990000,
+                                            0xCC0000, 0xFF0000, 0xFF3300, 0xFF6600,
+                                            0xFF9900, 0xFFCC00, 0xFFFF00, 0xFFFF33,
+                                            0xFFFF66, 0xFFFF99, 0xFFFFCC, 0xFFFFFF}};
+
+        inline constexpr Palette16 Ocean = {{0x191970, 0x00008B, 0x191970, 0x000080,
+                                             0x00008B, 0x0000CD, 0x2E8B57, 0x008080,
+                                             0x5F9EA0, 0x0000FF, 0x008B8B, 0x6495ED,
+                                             0x7FFFD4, 0x2E8B57, 0x00FFFF, 0x87CEFA}};
+
+        inline constexpr Palette16 Lava = {{0x000000, 0x800000, 0x000000, 0x800000,
+                                            0x8B0000, 0x800000, 0x8B0000, 0x8B0000,
+                                            0x8B0000, 0xFF0000, 0xFFA500, 0xFFFFFF,
+                                            0xFFA500, 0xFF0000, 0x8B0000, 0x000000}};
+
+        inline constexpr Palette16 Forest = {{0x006400, 0x006400, 0x556B2F, 0x006400,
+                                              0x008000, 0x228B22, 0x6B8E23, 0x008000,
+                                              0x2E8B57, 0x66CDAA, 0x32CD32, 0x9ACD32,
+                                              0x90EE90, 0x7CFC00, 0x66CDAA, 0x228B22}};
+    }
+};
@@ -0,0 +1,126 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "Color.hpp"
+namespace LedLib
+{
+    /**
+     * @brief Lookup tables generated at compile time
+     *
+     * Every table is a constexpr std::array, so it is computed by the compiler and stored in rodata. Nothing runs at startup.
+     */
+    namespace Tables
+    {
+        namespace detail
+        {
+            constexpr double PI = 3.14159265358979323846;
+            constexpr double LN2 = 0.69314718055994530942;
+
+            /// sin(x) for x in [0, pi/2] by Taylor series
+            constexpr double sin(double x)
+            {
+                double term = x;
+                double sum = x;
+                for (int n = 1; n < 12; n++)
+                {
+                    term *= -x * x / ((2 * n) * (2 * n + 1));
+                    sum += term;
+                }
+                return sum;
+            }
+
+            /// ln(x) for x > 0, range reduced to [0.5, 1] then summed as 2 * atanh((x - 1) / (x + 1))
+            constexpr double ln(double x)
+            {
+                int halvings = 0;
+                while (x < 0.5)
+                {
+                    x *= 2;
+                    halvings++;
+                }
+                double z = (x - 1) / (x + 1);
+                double term = z;
+                double sum = 0;
+                for (int n = 1; n < 40; n += 2)
+                {
+                    sum += term / n;
+                    term *= z * z;
+                }
+                return 2 * sum - halvings * LN2;
+            }
+
+            /// exp(x) for x <= 0, range reduced by halving then squared back up
+            constexpr double exp(double x)
+            {
+                int squarings = 0;
+                while (x < -0.5)
+                {
+                    x /= 2;
+                    squarings++;
+                }
+                double term = 1;
+                double sum = 1;
+                for (int n = 1; n < 20; n++)
+                {
+                    term *= x / n;
+                    sum += term;
+                }
+                for (int i = 0; i < squarings; i++)
+                    sum *= sum;
+                return sum;
+            }
+
+            /// x^y for x in [0, 1] and y > 0
+            constexpr double pow(double x, double y)
+            {
+                if (x <= 0)
+                    return 0;
+                return exp(y * ln(x));
+            }
+        }
+
+        /**
+         * @brief Build a 256 entry gamma correction table
+         *
+         * @param gamma the gamma exponent, 2.2-2.8 is typical for WS2812 style LEDs
+         */
+        constexpr std::array<uint8_t, 256> makeGammaTable(double gamma)
+        {
+            std::array<uint8_t, 256> table{};
+            for (int i = 0; i < 256; i++)
+                table[i] = static_cast<uint8_t>(detail::pow(i / 255.0, gamma) * 255.0 + 0.5);
+            return table;
+        }
+
+        /**
+         * @brief Build a 256 entry fully saturated rainbow, one hue step per entry
+         */
+        constexpr std::array<Color, 256> makeRainbowTable()
+        {
+            std::array<Color, 256> table{};
+            for (int i = 0; i < 256; i++)
+                table[i] = Color::fromHSV(static_cast<uint16_t>(i * Color::HUE_RING / 256), 255, 255);
+            return table;
+        }
+
+        /**
+         * @brief Build the first quarter of a sine wave, 0-127 over 0-64 (0 to pi/2), inclusive of both ends
+         */
+        constexpr std::array<uint8_t, 65> makeQuarterSineTable()
+        {
+            std::array<uint8_t, 65> table{};
+            for (int i = 0; i <= 64; i++)
+                table[i] = static_cast<uint8_t>(detail::sin(i * detail::PI / 128.0) * 127.0 + 0.5);
+            return table;
+        }
+
+        /// Fully saturated, full brightness rainbow indexed by an 8 bit hue
+        inline constexpr std::array<Color, 256> rainbow = makeRainbowTable();
+
+        /// Gamma 2.6 correction, applied to each channel separately
+        inline constexpr std::array<uint8_t, 256> gamma = makeGammaTable(2.6);
+
+        /// Quarter wave sine used by LedLib::sin8
+        inline constexpr std::array<uint8_t, 65> quarterSine = makeQuarterSineTable();
+    }
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "ShaderEffect.hpp"
+namespace LedLib
+{
+    /**
+     * @brief The whole strip fading smoothly up and down
+     *
+     * The level follows a table sine run through the gamma table, so the fade looks even to the eye.
+     * The color is computed once per frame; each LED is a copy. Budget: 30 us per 64 LEDs.
+     */
+    class BreatheEffect : public ShaderEffect<BreatheEffect>
+    {
+    public:
+        /// Parameter ids for LedLib::postParam
+        enum Param
+        {
+            Period,
+            Floor
+        };
+
+        /**
+         * @brief Construct a new Breathe Effect
+         *
+         * @param color the color at full brightness
+         * @param period milliseconds for one breath
+         * @param floor 0-255 lowest brightness, 0 to fade to off
+         */
+        BreatheEffect(Color color, uint16_t period = 3000, uint8_t floor = 0);
+
+        void prepare(LedLib &ledLib, const FrameContext &frame);
+        void setParam(int param, int32_t value) override;
+        uint32_t renderBudget() const override { return 30; }
+
+        Color shade(int index, uint16_t position, uint32_t time) const
+        {
+            return current;
+        }
+
+        Color color;
+        uint16_t period;
+        uint8_t floor;
+
+    private:
+        Color current;
+    };
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ShaderEffect.hpp"
+namespace LedLib
+{
+    /**
+     * @brief A block of lit LEDs running along the strip and wrapping around
+     *
+     * Integer only, one compare and add per LED. Budget: 40 us per 64 LEDs.
+     */
+    class ChaseEffect : public ShaderEffect<ChaseEffect>
+    {
+    public:
+        /// Parameter ids for LedLib::postParam
+        enum Param
+        {
+            Speed,
+            Length
+        };
+
+        /**
+         * @brief Construct a new Chase Effect
+         *
+         * @param color the color of the lit block
+         * @param background the color of every other LED
+         * @param length the number of LEDs in the block
+         * @param speed 1/256ths of an LED per millisecond, negative to reverse. 8 is about 31 LEDs per second.
+         */
+        ChaseEffect(Color color, Color background = Color(), uint8_t length = 4, int32_t speed = 8);
+
+        void prepare(LedLib &ledLib, const FrameContext &frame);
+        void setParam(int param, int32_t value) override;
+        uint32_t renderBudget() const override { return 40; }
+
+        Color shade(int index, uint16_t position, uint32_t time) const
+        {
+            int distance = index - (head >> 8);
+            if (distance < 0)
+                distance += stripSize;
+            return distance < length ? color : background;
+        }
+
+        Color color;
+        Color background;
+        uint8_t length;
+        int32_t speed;
+
+    private:
+        /// Position of the first LED of the block in 8.8 fixed point
+        int32_t head = 0;
+        int stripSize = 1;
+    };
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ShaderEffect.hpp"
+namespace LedLib
+{
+    /**
+     * @brief A bright head running along the strip with a tail that fades out behind it
+     *
+     * The head moves in 1/256ths of an LED and the LED it is entering is lit by the fraction it has covered, so
+     * slow comets glide instead of stepping. Integer only. Budget: 60 us per 64 LEDs.
+     */
+    class CometEffect : public ShaderEffect<CometEffect>
+    {
+    public:
+        /// Parameter ids for LedLib::postParam
+        enum Param
+        {
+            Speed,
+            Tail
+        };
+
+        /**
+         * @brief Construct a new Comet Effect
+         *
+         * @param color the color of the head
+         * @param tail the length of the tail in LEDs, at least 1
+         * @param speed 1/256ths of an LED per millisecond, negative to reverse. 8 is about 31 LEDs per second.
+         */
+        CometEffect(Color color, uint8_t tail = 8, int32_t speed = 8);
+
+        void prepare(LedLib &ledLib, const FrameContext &frame);
+        void setParam(int param, int32_t value) override;
+        uint32_t renderBudget() const override { return 60; }
+
+        Color shade(int index, uint16_t position, uint32_t time) const
+        {
+            if (speed < 0)
+                index = stripSize - 1 - index;
+            // How far behind the head this LED is, in 8.8 fixed point
+            int32_t distance = head - (index << 8);
+            if (distance < 0)
+                distance += wrap;
+            if (distance >= wrap - 256)
+                return color.scale(distance - (wrap - 256)); // the LED the head is moving into
+            if (distance >= tailLength)
+                return Color();
+            return color.scale(255 - ((distance * fade) >> 16));
+        }
+
+        Color color;
+        uint8_t tail;
+        int32_t speed;
+
+    private:
+        /// Position of the head in 8.8 fixed point, counted from the end the comet starts at
+        int32_t head = 0;
+        int32_t wrap = 256;
+        int32_t tailLength = 256;
+        /// Brightness lost per 1/256th of an LED behind the head, in 16.16 fixed point
+        int32_t fade = 0;
+        int stripSize = 1;
+    };
+};
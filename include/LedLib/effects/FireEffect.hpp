@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include "LedEffect.hpp"
+#include "../LedLib.hpp"
+#include "../Palette.hpp"
+namespace LedLib
+{
+    /**
+     * @brief Flickering fire rising from the start of the strip
+     *
+     * A heat simulation in the style of FastLED's Fire2012: every LED holds a uint8_t heat that cools a random amount
+     * each step, drifts up the strip and is mapped through a palette, while random sparks ignite near the base.
+     * Everything is integer, and the random numbers come from a per-instance xorshift generator, so two strips
+     * with different seeds never flicker in step. The simulation steps at a fixed rate whatever the frame rate.
+     *
+     * The heat array is fixed at MAX_CELLS and holds the strip the instance renders to, so give each strip its own
+     * FireEffect. A change of size resets the fire but never allocates.
+     */
+    class FireEffect : public LedEffect
+    {
+    public:
+        /// Parameter ids for LedLib::postParam
+        enum Param
+        {
+            Cooling,
+            Sparking
+        };
+
+        /**
+         * @brief Construct a new Fire Effect
+         *
+         * @param cooling 0-255 how fast the flames cool, higher gives shorter flames
+         * @param sparking 0-255 chance per step of a new spark, higher gives a busier fire
+         * @param seed random seed, give each strip a different one
+         * @param reversed put the base of the fire at the end of the strip instead of the start
+         * @param palette the colors from cold to hot, nullptr for Palettes::Heat. Must outlive the effect.
+         */
+        FireEffect(uint8_t cooling = 55, uint8_t sparking = 120, uint32_t seed = 1, bool reversed = false,
+                   const Palette256 *palette = nullptr);
+
+        void setup(LedLib &ledLib) override;
+        void update(LedLib &ledLib, const FrameContext &frame) override;
+        void onResize(LedLib &ledLib) override;
+        void setParam(int param, int32_t value) override;
+        uint32_t renderBudget() const override { return 80; }
+
+        uint8_t cooling;
+        uint8_t sparking;
+        bool reversed;
+
+        /// Milliseconds per simulation step
+        static constexpr uint32_t STEP = 16;
+        /// LEDs the heat array covers, the most a strip can address
+        static constexpr int MAX_CELLS = 256;
+
+    private:
+        void reset(int size);
+        void step();
+        uint32_t next();
+        uint8_t random8();
+        uint8_t random8(uint8_t limit);
+
+        std::array<uint8_t, MAX_CELLS> heat{};
+        /// Cells of heat in use, the size of the strip last rendered to
+        int heatSize = 0;
+        const Palette256 *palette;
+        uint32_t state;
+        uint32_t pending = 0;
+    };
+};
@@ -4,6 +4,11 @@
 #include "../LedLib.hpp"
 namespace LedLib
 {
+    /**
+     * @brief A static gradient between two colors
+     *
+     * The gradient LUT is sized for the strip the instance renders to, so give each strip its own GraidentEffect.
+     */
     class GraidentEffect : public LedEffect
     {
     public:
@@ -12,6 +17,16 @@ namespace LedLib
         GraidentEffect(RGB start, RGB end);
         GraidentEffect(HSV start, HSV end);
         void setup(LedLib &ledLib) override;
-        void update(LedLib &ledLib) override;
+        void update(LedLib &ledLib, const FrameContext &frame) override;
+        void onResize(LedLib &ledLib) override;
+
+    private:
+        void buildLut(int size);
+        static bool sameColor(const HSV &a, const HSV &b);
+
+        /// The precomputed color of every pixel, rebuilt when the strip size or either color changes
+        std::vector<Color> lut;
+        HSV builtStart;
+        HSV builtEnd;
     };
 };
\ No newline at end of file
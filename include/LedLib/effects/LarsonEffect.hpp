@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ShaderEffect.hpp"
+namespace LedLib
+{
+    /**
+     * @brief A Larson scanner: a glowing eye sweeping back and forth across the strip
+     *
+     * The eye is positioned in 1/256ths of an LED and falls off linearly to each side, so it moves smoothly
+     * at any speed. Integer only. Budget: 50 us per 64 LEDs.
+     */
+    class LarsonEffect : public ShaderEffect<LarsonEffect>
+    {
+    public:
+        /// Parameter ids for LedLib::postParam
+        enum Param
+        {
+            Period,
+            Width
+        };
+
+        /**
+         * @brief Construct a new Larson Effect
+         *
+         * @param color the color at the center of the eye
+         * @param width LEDs from the center of the eye to where it is dark, at least 1
+         * @param period milliseconds for a sweep there and back
+         * @param background the color outside the eye
+         */
+        LarsonEffect(Color color, uint8_t width = 3, uint16_t period = 2000, Color background = Color());
+
+        void prepare(LedLib &ledLib, const FrameContext &frame);
+        void setParam(int param, int32_t value) override;
+        uint32_t renderBudget() const override { return 50; }
+
+        Color shade(int index, uint16_t position, uint32_t time) const
+        {
+            int32_t distance = (index << 8) - eye;
+            if (distance < 0)
+                distance = -distance;
+            if (distance >= reach)
+                return background;
+            return Color::lerp(background, color, 255 - ((distance * fade) >> 16));
+        }
+
+        Color color;
+        uint8_t width;
+        uint16_t period;
+        Color background;
+
+    private:
+        /// Center of the eye in 8.8 fixed point
+        int32_t eye = 0;
+        int32_t reach = 256;
+        /// Brightness lost per 1/256th of an LED from the center, in 16.16 fixed point
+        int32_t fade = 0;
+    };
+};
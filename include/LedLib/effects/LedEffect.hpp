@@ -1,12 +1,75 @@
 #pragma once
+#include <cstdint>
 namespace LedLib {
 
     class LedLib;
 
+    /**
+     * @brief Timing information for the frame being rendered
+     *
+     * Effects should derive motion from time rather than counting update calls, so animations run at the
+     * same speed no matter how often frames are rendered, and a recorded sequence of contexts replays exactly.
+     */
+    struct FrameContext {
+        uint32_t time;  // timestamp of this frame in milliseconds
+        uint32_t delta; // milliseconds since the previous frame, 0 on the first frame
+        uint32_t frame; // number of frames rendered before this one
+    };
+
+    /**
+     * @brief Base class for effects
+     *
+     * LedLib drives the lifecycle: onAttach when the effect is added, onActivate/onDeactivate when it starts and
+     * stops being rendered, onResize when the strip length changes, and update once per frame in between.
+     * Do expensive preparation (LUTs, pools) in onAttach or setup, which runs from addEffect, so calling
+     * addEffect in initialize() keeps it off the first frame after a switch.
+     */
     class LedEffect {
         public:
-            virtual void setup( LedLib& ledLib) = 0;
-            virtual void update( LedLib& ledLib) = 0;
+            virtual ~LedEffect() = default;
+
+            /**
+             * @brief Prepare the effect for the given strip. Called by the default onAttach. Must not draw: the effect may not be on the strip.
+             */
+            virtual void setup( LedLib& ledLib) {}
+            virtual void update( LedLib& ledLib, const FrameContext& frame) = 0;
+
+            /**
+             * @brief Called once by LedLib::addEffect. Calls setup() unless overridden.
+             */
+            virtual void onAttach( LedLib& ledLib) { setup(ledLib); }
+
+            /**
+             * @brief Called when the effect becomes active or is added as a layer, before its first update
+             */
+            virtual void onActivate( LedLib& ledLib) {}
+
+            /**
+             * @brief Called when the effect stops being rendered. It won't be updated again until reactivated.
+             */
+            virtual void onDeactivate( LedLib& ledLib) {}
+
+            /**
+             * @brief Called by LedLib::resize after the strip length changed. ledLib.size holds the new length.
+             */
+            virtual void onResize( LedLib& ledLib) {}
+
+            /**
+             * @brief Change an effect specific parameter
+             *
+             * Called by the render task when it drains a LedLib::postParam command, so it never races update().
+             *
+             * @param param an id defined by the effect
+             * @param value the new value
+             */
+            virtual void setParam(int param, int32_t value) {}
+
+            /**
+             * @brief The most time update() should take, in microseconds per 64 LEDs
+             *
+             * When non-zero LedLib times every update and counts any that run over in LedLib::frameStats.overBudget,
+             * logging a warning when an effect starts running over. 0, the default, skips the check.
+             */
+            virtual uint32_t renderBudget() const { return 0; }
     };
 };
-
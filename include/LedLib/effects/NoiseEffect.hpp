@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ShaderEffect.hpp"
+#include "../Noise.hpp"
+#include "../Palette.hpp"
+namespace LedLib
+{
+    /**
+     * @brief A slowly churning noise field mapped through a palette
+     *
+     * Each LED samples 2D noise at (its position along the strip, time), so neighbouring LEDs stay related and the
+     * pattern flows instead of flickering. With Palettes::Lava, Ocean or Forest this gives lava, water and foliage
+     * looks with no floating point. Budget: 80 us per 64 LEDs.
+     */
+    class NoiseEffect : public ShaderEffect<NoiseEffect>
+    {
+    public:
+        /// Parameter ids for LedLib::postParam
+        enum Param
+        {
+            Scale,
+            Speed
+        };
+
+        /**
+         * @brief Construct a new Noise Effect
+         *
+         * @param palette the colors noise values map to, nullptr for Palettes::Lava. Must outlive the effect, so
+         *        declare it as a global, e.g. `Palette256 ocean(Palettes::Ocean);` and pass `&ocean`.
+         * @param scale 1/256ths of a noise cell per LED, smaller values give larger blobs
+         * @param speed 1/4096ths of a noise cell per millisecond, 16 is about 4 cells per second
+         * @param offset 8.8 fixed point starting point in the field, give strips different offsets so they differ
+         */
+        NoiseEffect(const Palette256 *palette = nullptr, uint16_t scale = 48, uint16_t speed = 4, uint32_t offset = 0);
+
+        void prepare(LedLib &ledLib, const FrameContext &frame);
+        void setParam(int param, int32_t value) override;
+        uint32_t renderBudget() const override { return 80; }
+
+        Color shade(int index, uint16_t position, uint32_t time) const
+        {
+            uint8_t level = Noise::noise8(offset + index * scale, depth);
+            // The noise bunches up around the middle, so stretch it to use the whole palette
+            int32_t stretched = (static_cast<int32_t>(level) - 128) * 2 + 128;
+            return (*palette)[stretched < 0 ? 0 : (stretched > 255 ? 255 : stretched)];
+        }
+
+        const Palette256 *palette;
+        uint16_t scale;
+        uint16_t speed;
+        uint32_t offset;
+
+    private:
+        /// The time axis of the field, in 8.8 fixed point
+        uint32_t depth = 0;
+        uint32_t depthFraction = 0;
+    };
+};
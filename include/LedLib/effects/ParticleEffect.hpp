@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "LedEffect.hpp"
+#include "../LedLib.hpp"
+#include "../MpscQueue.hpp"
+namespace LedLib
+{
+    /**
+     * @brief A group of particles to launch from one point, queued with ParticleEffect::emit
+     */
+    struct ParticleBurst
+    {
+        int32_t position = 0; // launch point in 8.8 fixed point LEDs
+        int32_t velocity = 0; // LEDs per second in 8.8 fixed point, negative towards the start of the strip
+        int32_t spread = 0;   // random +/- added to each particle's velocity, same units
+        Color color = 0xFFFFFF;
+        uint16_t life = 500;  // milliseconds until a particle has faded out
+        uint8_t count = 1;    // particles to launch
+    };
+
+    /**
+     * @brief A fixed size pool of particles moving along the strip
+     *
+     * Particles are stored as parallel arrays (position, velocity, color, life) with the live ones packed at the
+     * front, so a frame costs O(live particles) and the pool never touches the heap. Each particle is drawn
+     * additively across the two LEDs it sits between, weighted by how far along it is, so slow particles glide
+     * smoothly and overlapping ones brighten. Particles fade out over their life and die when they leave the strip.
+     *
+     * emit() can be called from any task, e.g. an intake or shooter routine; bursts wait on a lock-free queue
+     * until the next frame. Bursts arriving while the pool is full are cut short.
+     *
+     * @tparam N the most particles alive at once
+     */
+    template <size_t N>
+    class ParticleEffect : public LedEffect
+    {
+    public:
+        /**
+         * @brief Construct a new Particle Effect
+         *
+         * @param background the color behind the particles
+         * @param gravity LEDs per second per second in 8.8 fixed point, pulling towards the end of the strip
+         * @param seed random seed for spread, give each strip a different one
+         */
+        ParticleEffect(Color background = Color(), int32_t gravity = 0, uint32_t seed = 1)
+            : background(background), gravity(gravity), random((seed * UINT32_C(0x9E3779B9)) | 1) {}
+
+        /**
+         * @brief Queue a burst of particles for the next frame. Safe to call from any task.
+         *
+         * @return false if too many bursts are already waiting and this one was dropped
+         */
+        bool emit(const ParticleBurst &burst)
+        {
+            return this->bursts.push(burst);
+        }
+
+        /**
+         * @brief The number of particles currently alive
+         */
+        int active() const
+        {
+            return this->count;
+        }
+
+        void update(LedLib &ledLib, const FrameContext &frame) override
+        {
+            ParticleBurst burst;
+            while (this->bursts.pop(burst))
+                this->spawn(burst);
+
+            // Cap the step so a stall doesn't fling everything off the strip
+            int32_t dt = frame.delta > 100 ? 100 : frame.delta;
+            // 8.8 LEDs per second squared to 16.16 LEDs per millisecond, per elapsed millisecond
+            int32_t pull = static_cast<int64_t>(this->gravity) * dt * 256 / 1000000;
+            int32_t end = static_cast<int32_t>(ledLib.size) << 16;
+
+            for (int i = 0; i < this->count;)
+            {
+                this->velocity[i] += pull;
+                this->position[i] += this->velocity[i] * dt;
+                if (this->remaining[i] <= dt || this->position[i] < -(1 << 16) || this->position[i] >= end)
+                {
+                    this->kill(i);
+                    continue;
+                }
+                this->remaining[i] -= dt;
+                i++;
+            }
+
+            Color fill = this->background;
+            ledLib.generate([fill](int index)
+                            { return fill; });
+            for (int i = 0; i < this->count; i++)
+                this->splat(ledLib, i);
+        }
+
+        uint32_t renderBudget() const override { return 100; }
+
+        Color background;
+        int32_t gravity;
+
+    private:
+        void spawn(const ParticleBurst &burst)
+        {
+            for (int n = 0; n < burst.count && this->count < static_cast<int>(N); n++)
+            {
+                int32_t speed = burst.velocity;
+                if (burst.spread > 0)
+                    speed += static_cast<int32_t>(this->next() % (2 * static_cast<uint32_t>(burst.spread) + 1)) - burst.spread;
+                int i = this->count++;
+                this->position[i] = burst.position << 8;
+                // 8.8 LEDs per second to 16.16 LEDs per millisecond
+                this->velocity[i] = speed * 256 / 1000;
+                this->color[i] = burst.color;
+                this->remaining[i] = burst.life > 0 ? burst.life : 1;
+                this->life[i] = this->remaining[i];
+            }
+        }
+
+        /// Remove a particle by moving the last live one into its slot
+        void kill(int i)
+        {
+            int last = --this->count;
+            this->position[i] = this->position[last];
+            this->velocity[i] = this->velocity[last];
+            this->color[i] = this->color[last];
+            this->remaining[i] = this->remaining[last];
+            this->life[i] = this->life[last];
+        }
+
+        /// Add a particle to the two LEDs around it, split by its fractional position
+        void splat(LedLib &ledLib, int i)
+        {
+            uint8_t brightness = static_cast<uint32_t>(this->remaining[i]) * 255 / this->life[i];
+            Color lit = this->color[i].scale(brightness);
+            int32_t at = this->position[i] >> 8;
+            int index = at >> 8;
+            uint8_t fraction = at & 0xFF;
+            if (index >= 0 && fraction != 255)
+                ledLib.setPixel(Blend::add(ledLib.getPixel(index), lit.scale(255 - fraction)), index);
+            if (index + 1 < ledLib.size && fraction != 0)
+                ledLib.setPixel(Blend::add(ledLib.getPixel(index + 1), lit.scale(fraction)), index + 1);
+        }
+
+        uint32_t next()
+        {
+            this->random ^= this->random << 13;
+            this->random ^= this->random >> 17;
+            this->random ^= this->random << 5;
+            return this->random;
+        }
+
+        // Structure of arrays, live particles packed into [0, count)
+        int32_t position[N];  // 16.16 fixed point LEDs
+        int32_t velocity[N];  // 16.16 fixed point LEDs per millisecond
+        Color color[N];
+        uint16_t remaining[N]; // milliseconds left
+        uint16_t life[N];      // milliseconds the particle started with
+        int count = 0;
+
+        uint32_t random;
+        MpscQueue<ParticleBurst, 16> bursts;
+    };
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "ShaderEffect.hpp"
+namespace LedLib
+{
+    /**
+     * @brief Base for effects that compute each pixel from its index alone, dispatched at compile time
+     *
+     * Derive as `class MyEffect : public PixelEffect<MyEffect>` and define
+     *
+     *     Color pixel(int index);                                  // the color of one LED
+     *     void prepare(LedLib &ledLib, const FrameContext &frame); // optional, once per frame
+     *
+     * A ShaderEffect whose shade() forwards to pixel(), so it runs through the same LedLib::shade loop, with the
+     * same clipping and masking, and pixel() is inlined into it. LedLib still sees an ordinary LedEffect, so one
+     * virtual update() per frame remains, and calling update() on the derived type directly skips even that.
+     *
+     * @tparam Derived the effect deriving from this class
+     */
+    template <typename Derived>
+    class PixelEffect : public ShaderEffect<Derived>
+    {
+    public:
+        Color shade(int index, uint16_t position, uint32_t time)
+        {
+            return static_cast<Derived &>(*this).pixel(index);
+        }
+    };
+};
@@ -1,13 +1,49 @@
 #pragma once
 
-#include "LedEffect.hpp"
+#include "ShaderEffect.hpp"
 #include "../LedLib.hpp"
 namespace LedLib
 {
-    class RainbowEffect : public LedEffect
+    /**
+     * @brief A rainbow scrolling along the strip
+     *
+     * All animation state lives in the instance, so give each strip its own RainbowEffect.
+     * Instances with different phases stay offset from each other.
+     */
+    class RainbowEffect : public ShaderEffect<RainbowEffect>
     {
     public:
-        void setup(LedLib &ledLib) override;
-        void update(LedLib &ledLib) override;
+        /// Parameter ids for LedLib::postParam
+        enum Param
+        {
+            Speed,
+            Phase
+        };
+
+        /**
+         * @brief Construct a new Rainbow Effect
+         *
+         * @param speed rainbow table steps per millisecond in 8.8 fixed point, negative to reverse. 24 is about 133 degrees per second.
+         * @param phase 0-255 starting offset around the color wheel
+         */
+        RainbowEffect(int32_t speed = 24, uint8_t phase = 0);
+
+        void prepare(LedLib &ledLib, const FrameContext &frame);
+        void setParam(int param, int32_t value) override;
+
+        /**
+         * @brief The color of one LED, a hue step of 2 degrees per LED from the current offset
+         */
+        Color shade(int index, uint16_t position, uint32_t time) const
+        {
+            // 364/256 table steps is 2 degrees
+            return LedLib::rainbow((offsetHue + index * 364) >> 8);
+        }
+
+        int32_t speed;
+
+    private:
+        /// Offset into the rainbow table in 8.8 fixed point
+        uint16_t offsetHue;
     };
-};
\ No newline at end of file
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "LedEffect.hpp"
+#include "../LedLib.hpp"
+namespace LedLib
+{
+    /**
+     * @brief Base for effects written as a per-pixel function, with the loop owned by LedLib::shade
+     *
+     * Derive as `class MyEffect : public ShaderEffect<MyEffect>` and define
+     *
+     *     Color shade(int index, uint16_t position, uint32_t time);  // the color of one LED
+     *     void prepare(LedLib &ledLib, const FrameContext &frame);    // optional, once per frame
+     *
+     * position runs from 0 at the first LED to 65535 at the last, so a shader can be written without knowing the
+     * strip length. shade() should only read the effect's state; anything that changes over a frame belongs in
+     * prepare(). LedLib clips, masks and tracks changes, so a shader cannot write out of bounds.
+     *
+     * @tparam Derived the effect deriving from this class
+     */
+    template <typename Derived>
+    class ShaderEffect : public LedEffect
+    {
+    public:
+        void update(LedLib &ledLib, const FrameContext &frame) final
+        {
+            Derived &self = static_cast<Derived &>(*this);
+            self.prepare(ledLib, frame);
+            ledLib.shade([&self](int index, uint16_t position, uint32_t time)
+                         { return self.shade(index, position, time); },
+                         frame.time);
+        }
+
+        /**
+         * @brief Called once per frame before any shade(). Hide it in Derived to advance animation state.
+         */
+        void prepare(LedLib &ledLib, const FrameContext &frame) {}
+    };
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "ShaderEffect.hpp"
+namespace LedLib
+{
+    /**
+     * @brief The whole strip flashing on and off
+     *
+     * Decided once per frame from the frame time, so flashes stay on the beat whatever the frame rate. Flashes
+     * shorter than a frame may be missed. Budget: 30 us per 64 LEDs.
+     */
+    class StrobeEffect : public ShaderEffect<StrobeEffect>
+    {
+    public:
+        /// Parameter ids for LedLib::postParam
+        enum Param
+        {
+            Period,
+            OnTime
+        };
+
+        /**
+         * @brief Construct a new Strobe Effect
+         *
+         * @param color the color of a flash
+         * @param period milliseconds from one flash to the next
+         * @param onTime milliseconds each flash lasts
+         * @param background the color between flashes
+         */
+        StrobeEffect(Color color, uint16_t period = 100, uint16_t onTime = 20, Color background = Color());
+
+        void prepare(LedLib &ledLib, const FrameContext &frame);
+        void setParam(int param, int32_t value) override;
+        uint32_t renderBudget() const override { return 30; }
+
+        Color shade(int index, uint16_t position, uint32_t time) const
+        {
+            return current;
+        }
+
+        Color color;
+        uint16_t period;
+        uint16_t onTime;
+        Color background;
+
+    private:
+        Color current;
+    };
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ShaderEffect.hpp"
+namespace LedLib
+{
+    /**
+     * @brief Every Nth LED lit, stepping one LED along at a fixed interval like a marquee
+     *
+     * Integer only. The per-LED remainder uses a multiply by a reciprocal computed once per frame, since the
+     * V5's Cortex-A9 has no divide instruction. Budget: 40 us per 64 LEDs.
+     */
+    class TheaterChaseEffect : public ShaderEffect<TheaterChaseEffect>
+    {
+    public:
+        /// Parameter ids for LedLib::postParam
+        enum Param
+        {
+            Spacing,
+            Interval
+        };
+
+        /**
+         * @brief Construct a new Theater Chase Effect
+         *
+         * @param color the color of the lit LEDs
+         * @param background the color of every other LED
+         * @param spacing light one LED in every spacing, at least 1
+         * @param interval milliseconds between steps
+         */
+        TheaterChaseEffect(Color color, Color background = Color(), uint8_t spacing = 3, uint16_t interval = 80);
+
+        void prepare(LedLib &ledLib, const FrameContext &frame);
+        void setParam(int param, int32_t value) override;
+        uint32_t renderBudget() const override { return 40; }
+
+        Color shade(int index, uint16_t position, uint32_t time) const
+        {
+            // (index + step) % spacing for 16 bit operands, by Lemire's fastmod
+            uint32_t low = reciprocal * static_cast<uint32_t>(index + step);
+            uint32_t remainder = (static_cast<uint64_t>(low) * spacing) >> 32;
+            return remainder == 0 ? color : background;
+        }
+
+        Color color;
+        Color background;
+        uint8_t spacing;
+        uint16_t interval;
+
+    private:
+        uint32_t reciprocal = 0;
+        int step = 0;
+    };
+};
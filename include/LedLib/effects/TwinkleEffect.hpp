@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ShaderEffect.hpp"
+namespace LedLib
+{
+    /**
+     * @brief LEDs randomly fading in and out over a background
+     *
+     * Stateless: each LED hashes its index and the current twinkle cycle to decide whether it lights and when,
+     * so there is no per-LED storage and the effect works at any strip length. Integer only, two hashes per LED.
+     * Budget: 60 us per 64 LEDs.
+     */
+    class TwinkleEffect : public ShaderEffect<TwinkleEffect>
+    {
+    public:
+        /// Parameter ids for LedLib::postParam
+        enum Param
+        {
+            Density,
+            Seed
+        };
+
+        /**
+         * @brief Construct a new Twinkle Effect
+         *
+         * @param color the color at the peak of a twinkle
+         * @param density 0-255 chance that an LED twinkles each cycle
+         * @param period milliseconds one twinkle lasts, rounded down to a power of two, at least 256
+         * @param background the color of LEDs that aren't twinkling
+         * @param seed changes the pattern, give strips different seeds so they don't twinkle in step
+         */
+        TwinkleEffect(Color color, uint8_t density = 64, uint16_t period = 1024, Color background = Color(), uint32_t seed = 0);
+
+        void setParam(int param, int32_t value) override;
+        uint32_t renderBudget() const override { return 60; }
+
+        Color shade(int index, uint16_t position, uint32_t time) const
+        {
+            uint32_t offset = hash(index ^ seed);
+            // Each LED runs its own cycle, offset so they don't all start together
+            uint32_t local = time + offset;
+            uint32_t cycle = local >> periodShift;
+            if ((hash(offset + cycle) & 0xFF) >= density)
+                return background;
+            uint8_t phase = local >> (periodShift - 8);
+            uint8_t level = phase < 128 ? phase * 2 : (255 - phase) * 2;
+            return Color::lerp(background, color, level);
+        }
+
+        Color color;
+        uint8_t density;
+        Color background;
+        uint32_t seed;
+
+    private:
+        /// Integer hash with good avalanche, from Chris Wellons' hash prospector
+        static uint32_t hash(uint32_t x)
+        {
+            x ^= x >> 16;
+            x *= UINT32_C(0x7feb352d);
+            x ^= x >> 15;
+            x *= UINT32_C(0x846ca68b);
+            x ^= x >> 16;
+            return x;
+        }
+
+        uint8_t periodShift;
+    };
+};
@@ -0,0 +1,62 @@
+#include "Blend.hpp"
+namespace LedLib
+{
+    namespace Blend
+    {
+        namespace
+        {
+            template <Color (*Kernel)(Color, Color)>
+            void rowWith(Color *below, const Color *above, int count, uint8_t opacity)
+            {
+                if (opacity == 255)
+                {
+                    for (int i = 0; i < count; i++)
+                        below[i] = Kernel(below[i], above[i]);
+                }
+                else
+                {
+                    for (int i = 0; i < count; i++)
+                        below[i] = Color::lerp(below[i], Kernel(below[i], above[i]), opacity);
+                }
+            }
+
+            constexpr Color normal(Color below, Color above)
+            {
+                return above;
+            }
+        }
+
+        /**
+         * @brief Blend a whole row of pixels in one pass
+         *
+         * @param below the pixels to blend into, overwritten with the result
+         * @param above the layer pixels
+         * @param count the number of pixels
+         * @param mode how to combine them
+         * @param opacity 0-255 strength of the layer
+         */
+        void row(Color *below, const Color *above, int count, BlendMode mode, uint8_t opacity)
+        {
+            if (opacity == 0)
+                return;
+            switch (mode)
+            {
+            case BlendMode::Normal:
+                rowWith<normal>(below, above, count, opacity);
+                break;
+            case BlendMode::Add:
+                rowWith<add>(below, above, count, opacity);
+                break;
+            case BlendMode::Multiply:
+                rowWith<multiply>(below, above, count, opacity);
+                break;
+            case BlendMode::Screen:
+                rowWith<screen>(below, above, count, opacity);
+                break;
+            case BlendMode::Max:
+                rowWith<max>(below, above, count, opacity);
+                break;
+            }
+        }
+    }
+};
@@ -1,4 +1,10 @@
 #include "LedLib.hpp"
+#include "Log.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include "Tables.hpp"
 namespace LedLib
 {
     /**
@@ -10,9 +16,14 @@ namespace LedLib
      * @throws StripSizeTooLarge if size is > 64
      */
     LedLib::LedLib(uint8_t adiport, int length)
-        : size(length), strip(adiport, length)
+        : port(pros::c::ext_adi_led_init(INTERNAL_ADI_PORT, adiport)), size(0)
     {
+        this->addPort(this->port, length);
+        this->size = this->ports[0].length;
+        this->buffer.assign(this->size, 0);
+        this->target = this->buffer.data();
         this->activeEffect = -1;
+        this->invalidate();
     }
 
     /**
@@ -24,11 +35,62 @@ namespace LedLib
      *
      * @throws StripSizeTooLarge if size is > 64
      */
-    LedLib::LedLib(uint8_t smartport, uint8_t adiport, int length) : strip({smartport, adiport}, length)
+    LedLib::LedLib(uint8_t smartport, uint8_t adiport, int length)
+        : port(pros::c::ext_adi_led_init(smartport, adiport)), size(0)
     {
-        // this->strip = pros::ADILed({smartport, adiport}, length);
-        this->size = length;
+        this->addPort(this->port, length);
+        this->size = this->ports[0].length;
+        this->buffer.assign(this->size, 0);
+        this->target = this->buffer.data();
+        this->activeEffect = -1;
+        this->invalidate();
+    }
+
+    /**
+     * @brief Construct one logical strip from several physical strips, chained end to end
+     *
+     * @param ports the physical strips in order, at most MAX_PORTS, each 1-64 LEDs
+     */
+    LedLib::LedLib(std::initializer_list<StripPort> ports)
+        : port(0), size(0)
+    {
+        for (const StripPort &strip : ports)
+        {
+            pros::c::ext_adi_led_t handle = pros::c::ext_adi_led_init(strip.smartport, strip.adiport);
+            if (this->portCount == 0)
+                this->port = handle;
+            this->addPort(handle, strip.length);
+        }
+        if (this->portCount > 0)
+            this->size = this->ports[this->portCount - 1].offset + this->ports[this->portCount - 1].length;
+        this->buffer.assign(this->size, 0);
+        this->target = this->buffer.data();
         this->activeEffect = -1;
+        this->invalidate();
+    }
+
+    /**
+     * @brief Append a physical strip to the end of the logical one
+     */
+    void LedLib::addPort(pros::c::ext_adi_led_t handle, int length)
+    {
+        if (this->portCount >= MAX_PORTS)
+        {
+            LEDLIB_LOG_ERROR("LedLib: more than %d ports, the rest are ignored", MAX_PORTS);
+            return;
+        }
+        if (length > MAX_PORT_LENGTH)
+        {
+            LEDLIB_LOG_WARN("LedLib: %d LEDs on one port, the ADI only drives %d", length, MAX_PORT_LENGTH);
+            length = MAX_PORT_LENGTH;
+        }
+        if (length < 0)
+            length = 0;
+        PortSlice &slice = this->ports[this->portCount];
+        slice.port = handle;
+        slice.offset = this->portCount == 0 ? 0 : this->ports[this->portCount - 1].offset + this->ports[this->portCount - 1].length;
+        slice.length = length;
+        this->portCount++;
     }
 
     /**
@@ -38,7 +100,7 @@ namespace LedLib
      */
     void LedLib::setAll(RGB rgb)
     {
-        this->strip.set_all(RGBtoUINT32(rgb));
+        this->fill(RGBtoUINT32(rgb));
     }
 
     /**
@@ -46,11 +108,21 @@ namespace LedLib
      *
      * @param hsv an HSV value represented as a struct
      *
-     * @note Converts HSV to RGB, then calls setAll(RGB) for simplicity
+     * @note Converts HSV to RGB once, then fills the frame buffer
      */
     void LedLib::setAll(HSV hsv)
     {
-        this->strip.set_all(HSVtoUINT32(hsv));
+        this->fill(HSVtoUINT32(hsv));
+    }
+
+    /**
+     * @brief Set all leds to a given color
+     *
+     * @param color a packed Color or 0xRRGGBB literal
+     */
+    void LedLib::setAll(Color color)
+    {
+        this->fill(color);
     }
 
     /**
@@ -62,10 +134,11 @@ namespace LedLib
      */
     void LedLib::setAllButchy(RGB rgb)
     {
-        uint32_t color = RGBtoUINT32(rgb);
+        Color color = RGBtoUINT32(rgb);
         for (int index = 0; index < this->size; index++)
         {
-            this->strip.set_pixel(color, index);
+            this->writePixel(index, color);
+            this->commit();
             pros::delay(5);
         }
     }
@@ -79,10 +152,11 @@ namespace LedLib
      */
     void LedLib::setAllButchy(HSV hsv)
     {
-        uint32_t color = HSVtoUINT32(hsv);
+        Color color = HSVtoUINT32(hsv);
         for (int index = 0; index < this->size; index++)
         {
-            this->strip.set_pixel(color, index);
+            this->writePixel(index, color);
+            this->commit();
             pros::delay(5);
         }
     }
@@ -95,7 +169,9 @@ namespace LedLib
      */
     void LedLib::setPixel(RGB rgb, uint8_t index)
     {
-        this->strip.set_pixel(RGBtoUINT32(rgb), index);
+        if (index >= this->size)
+            return;
+        this->writePixel(index, RGBtoUINT32(rgb));
     }
 
     /**
@@ -104,33 +180,891 @@ namespace LedLib
      * @param hsv rgb the RGB color to set the strip to
      * @param index the index of the LED
      *
-     * @note Converts HSV to RGB, then calls setPixel(RGB) for simplicity
+     * @note Converts HSV to RGB, then writes it to the frame buffer
      */
     void LedLib::setPixel(HSV hsv, uint8_t index)
     {
-        this->strip.set_pixel(HSVtoUINT32(hsv), index);
+        if (index >= this->size)
+            return;
+        this->writePixel(index, HSVtoUINT32(hsv));
+    }
+
+    /**
+     * @brief Set a given pixel to a specified color
+     *
+     * @param color a packed Color or 0xRRGGBB literal
+     * @param index the index of the LED
+     */
+    void LedLib::setPixel(Color color, uint8_t index)
+    {
+        if (index >= this->size)
+            return;
+        this->writePixel(index, color);
+    }
+
+    /**
+     * @brief Copy a run of colors into the frame buffer
+     *
+     * @param colors the colors to copy
+     * @param count the number of colors
+     * @param start the index of the first LED to write
+     */
+    void LedLib::setPixels(const Color *colors, int count, int start)
+    {
+        if (start < 0)
+        {
+            colors -= start;
+            count += start;
+            start = 0;
+        }
+        if (start + count > this->size)
+            count = this->size - start;
+        for (int i = 0; i < count; i++)
+            this->writePixel(start + i, colors[i]);
+    }
+
+    /**
+     * @brief Get the color of a given pixel in the frame buffer
+     *
+     * @param index the index of the LED
+     * @return The color, or off if index is out of range
+     */
+    Color LedLib::getPixel(uint8_t index) const
+    {
+        if (index >= this->size)
+            return Color();
+        return this->target[index];
+    }
+
+    /**
+     * @brief Set every pixel in the frame buffer to off
+     */
+    void LedLib::clear()
+    {
+        this->fill(0);
+    }
+
+    /**
+     * @brief Push the frame buffer to the strip in a single write
+     *
+     * @return PROS_SUCCESS if successful, PROS_ERR if not
+     */
+    int32_t LedLib::commit()
+    {
+        if (this->dirtyStart >= this->dirtyEnd)
+        {
+            this->stats.skipped++;
+            return PROS_SUCCESS;
+        }
+
+        // The strip is a shift chain, so pixels past the last changed one keep their latched color
+        // and only the prefix up to dirtyEnd has to be clocked out. Each port gets that prefix of its own slice,
+        // pointing straight into the frame buffer, and ports entirely outside the dirty range are skipped.
+        int32_t result = PROS_SUCCESS;
+        uint32_t sent = 0;
+        uint64_t started = pros::micros();
+        for (int i = 0; i < this->portCount; i++)
+        {
+            const PortSlice &slice = this->ports[i];
+            int end = std::min(slice.offset + slice.length, this->size);
+            if (this->dirtyStart >= end || this->dirtyEnd <= slice.offset)
+                continue;
+            uint32_t count = std::min(this->dirtyEnd, end) - slice.offset;
+            int32_t written = pros::c::ext_adi_led_set(slice.port, reinterpret_cast<uint32_t *>(this->buffer.data() + slice.offset), count);
+            if (written == PROS_ERR)
+                result = PROS_ERR;
+            sent += count;
+        }
+        uint32_t latency = pros::micros() - started;
+        this->stats.lastMicros = latency;
+        if (latency > this->stats.maxMicros)
+            this->stats.maxMicros = latency;
+        this->stats.totalMicros += latency;
+        if (result == PROS_ERR)
+        {
+            // Keep the dirty range so the next commit retries instead of leaving the strip out of sync
+            this->stats.failed++;
+            if (!this->commitFailing)
+                LEDLIB_LOG_WARN("commit: ext_adi_led_set failed, errno %d", errno);
+            this->commitFailing = true;
+            return result;
+        }
+        this->commitFailing = false;
+        this->stats.commits++;
+        this->stats.pixelsSent += sent;
+        this->dirtyStart = this->size;
+        this->dirtyEnd = 0;
+        return result;
+    }
+
+    /**
+     * @brief Mark the whole frame buffer as changed so the next commit resends every pixel
+     */
+    void LedLib::invalidate()
+    {
+        this->dirtyStart = 0;
+        this->dirtyEnd = this->size;
+    }
+
+    /**
+     * @brief Reset the counters in stats and frameStats to zero
+     */
+    void LedLib::resetStats()
+    {
+        this->stats = CommitStats();
+        this->frameStats = FrameStats();
+    }
+
+    /**
+     * @brief Start a task that calls updateEffects() at a fixed frame rate
+     *
+     * @param fps 1-1000 frames per second. The period is rounded down to whole milliseconds.
+     * @param priority the priority of the render task
+     */
+    void LedLib::start(uint32_t fps, uint32_t priority)
+    {
+        if (this->running)
+            return;
+        if (fps < 1)
+            fps = 1;
+        if (fps > 1000)
+            fps = 1000;
+        this->framePeriod = 1000 / fps;
+        this->prepare();
+        this->running = true;
+        Log::start();
+        this->renderTask = std::make_unique<pros::Task>([this]
+                                                        { this->renderLoop(); },
+                                                        priority, TASK_STACK_DEPTH_DEFAULT, "LedLib Render");
+    }
+
+    /**
+     * @brief Allocate the scratch frames ahead of rendering
+     */
+    void LedLib::prepare()
+    {
+        this->allocateScratch();
+    }
+
+    /**
+     * @brief Stop the render task, waiting for the frame in progress to finish
+     */
+    void LedLib::stop()
+    {
+        if (!this->running)
+            return;
+        this->running = false;
+        this->renderTask->join();
+        this->renderTask.reset();
+    }
+
+    /**
+     * @brief Whether the render task is running
+     */
+    bool LedLib::isRunning() const
+    {
+        return this->running;
+    }
+
+    /**
+     * @brief Body of the render task
+     *
+     * A frame is late when it finishes after the start of the next frame. Any whole frame slots it
+     * overran are dropped instead of being rendered back to back, so a stall never causes a burst.
+     */
+    void LedLib::renderLoop()
+    {
+        uint32_t wake = pros::millis();
+        while (this->running)
+        {
+            this->updateEffects();
+            this->frameStats.endFrame(wake, this->framePeriod);
+        }
+    }
+
+    /**
+     * @brief Count a finished frame and sleep until the next one
+     *
+     * A frame that overran its deadline counts as late, and the slots it overran are dropped rather than rendered
+     * back to back to catch up.
+     */
+    void LedLib::FrameStats::endFrame(uint32_t &wake, uint32_t period)
+    {
+        this->frames++;
+        uint32_t elapsed = pros::millis() - wake;
+        if (elapsed > period)
+        {
+            uint32_t missed = elapsed / period - 1;
+            this->late++;
+            this->dropped += missed;
+            wake += missed * period;
+        }
+        pros::Task::delay_until(&wake, period);
+    }
+
+    /**
+     * @brief Write a pixel, growing the dirty range only if the color actually changed
+     */
+    void LedLib::writePixel(int index, Color color)
+    {
+        if (this->masking() && this->targetOffset + index < static_cast<int>(this->mask.size()) &&
+            !this->mask[this->targetOffset + index])
+            return;
+        Color &pixel = this->target[index];
+        if (pixel == color)
+            return;
+        pixel = color;
+        this->markDirty(this->target, index, index + 1);
+    }
+
+    /**
+     * @brief Set every pixel in the frame buffer to one color through writePixel
+     */
+    void LedLib::fill(Color color)
+    {
+        for (int index = 0; index < this->size; index++)
+            this->writePixel(index, color);
     }
 
     void LedLib::setActiveEffect(int active)
     {
+        this->cancelTransition();
+        if (active == this->activeEffect)
+            return;
+        // Behind layers or segments the active effect isn't rendered, so it is only activated once they are cleared
+        bool shown = this->layerCount == 0 && this->segmentCount == 0;
+        if (shown && this->validEffect(this->activeEffect))
+            this->effects[this->activeEffect]->onDeactivate(*this);
+        this->activeEffect = active;
+        if (shown && this->validEffect(this->activeEffect))
+            this->effects[this->activeEffect]->onActivate(*this);
+    }
+
+    /**
+     * @brief Crossfade from the current effect to another
+     *
+     * @param active the index returned by addEffect
+     * @param duration length of the fade in milliseconds, 0 switches instantly
+     * @param curve the shape of the fade
+     */
+    void LedLib::setActiveEffect(int active, uint32_t duration, Easing curve)
+    {
+        int outgoing = this->activeEffect;
+        // Layers and segments replace the active effect, so there is nothing on the strip to fade
+        if (duration == 0 || active == outgoing || !this->validEffect(outgoing) || this->layerCount > 0 ||
+            this->segmentCount > 0)
+        {
+            this->setActiveEffect(active);
+            return;
+        }
+        // Normally already done by start(), so a fade posted to the render task doesn't allocate there
+        this->allocateScratch();
+        this->cancelTransition();
         this->activeEffect = active;
+        if (this->validEffect(active))
+            this->effects[active]->onActivate(*this);
+        this->transitionFrom = outgoing;
+        this->transitionStarted = false;
+        this->transitionDuration = duration;
+        this->transitionCurve = curve;
+    }
+
+    /**
+     * @brief End a crossfade in progress, leaving only the incoming effect running
+     */
+    void LedLib::cancelTransition()
+    {
+        if (this->transitionFrom < 0)
+            return;
+        this->effects[this->transitionFrom]->onDeactivate(*this);
+        this->transitionFrom = -1;
+    }
+
+    /**
+     * @brief Whether a crossfade started by setActiveEffect is still running
+     */
+    bool LedLib::isTransitioning() const
+    {
+        return this->transitionFrom >= 0;
+    }
+
+    /**
+     * @brief Replace the clock that timestamps frames
+     *
+     * @param clock a function returning milliseconds, pros::millis by default
+     */
+    void LedLib::setClock(uint32_t (*clock)())
+    {
+        this->clock = clock;
     }
 
     int LedLib::addEffect(LedEffect *customEffect)
     {
-        this->effects.push_back(customEffect);
-        return effects.size() - 1;
+        if (this->effectCount >= MAX_EFFECTS)
+        {
+            LEDLIB_LOG_ERROR("addEffect: already at %d effects", MAX_EFFECTS);
+            return -1;
+        }
+        this->effects[this->effectCount] = customEffect;
+        customEffect->onAttach(*this);
+        return this->effectCount++;
+    }
+
+    /**
+     * @brief Bytes of the effect arena in use
+     */
+    size_t LedLib::arenaUsed() const
+    {
+        return this->arenaOffset;
+    }
+
+    void LedLib::effectArenaFull(size_t requested)
+    {
+        LEDLIB_LOG_ERROR("emplaceEffect: no room for %u more bytes or effect slots", static_cast<unsigned>(requested));
+    }
+
+    /**
+     * @brief Stop rendering and destroy every effect built by emplaceEffect
+     */
+    LedLib::~LedLib()
+    {
+        this->stop();
+        for (int i = this->effectCount - 1; i >= 0; i--)
+        {
+            if (this->owned[i])
+                this->effects[i]->~LedEffect();
+        }
+    }
+
+    /**
+     * @brief Change the number of LEDs driven, then call onResize on every effect
+     *
+     * @param length 1-64 representing the length of the LEDs
+     */
+    void LedLib::resize(int length)
+    {
+        int limit = (this->portCount > 0 ? this->ports[this->portCount - 1].offset : 0) + MAX_PORT_LENGTH;
+        if (length > limit)
+        {
+            LEDLIB_LOG_WARN("resize: %d LEDs, the last port only reaches %d", length, limit);
+            length = limit;
+        }
+        if (length < 0)
+            length = 0;
+        if (length == this->size)
+            return;
+        this->size = length;
+        this->buffer.resize(length);
+        // Only the last port grows or shrinks; ports past the new end are left out of commits
+        if (this->portCount > 0)
+        {
+            PortSlice &last = this->ports[this->portCount - 1];
+            last.length = std::max(0, length - last.offset);
+        }
+        this->target = this->buffer.data();
+        if (!this->composeBuffer.empty())
+        {
+            this->composeBuffer.resize(length);
+            this->layerBuffer.resize(length);
+        }
+        this->invalidate();
+        for (int i = 0; i < this->effectCount; i++)
+            this->effects[i]->onResize(*this);
     }
 
+    /**
+     * @brief Render one frame of the active effect and commit it, timed by the clock
+     */
     void LedLib::updateEffects()
     {
-        if (this->activeEffect < 0)
+        this->render();
+        this->commit();
+    }
+
+    /**
+     * @brief Render one frame of the active effect with an explicit frame context and commit it
+     *
+     * @param frame the timing the effect sees
+     */
+    void LedLib::updateEffects(const FrameContext &frame)
+    {
+        this->render(frame);
+        this->commit();
+    }
+
+    /**
+     * @brief Render one frame of the active effect into the frame buffer without committing it, timed by the clock
+     */
+    void LedLib::render()
+    {
+        uint32_t now = this->clock();
+        FrameContext frame;
+        frame.time = now;
+        frame.delta = this->frameNumber == 0 ? 0 : now - this->lastFrameTime;
+        frame.frame = this->frameNumber;
+        this->lastFrameTime = now;
+        this->frameNumber++;
+        this->render(frame);
+    }
+
+    /**
+     * @brief Render one frame with an explicit frame context without committing it
+     *
+     * @param frame the timing the effect sees
+     */
+    void LedLib::render(const FrameContext &frame)
+    {
+        this->processCommands();
+        this->rendering = true;
+        if (this->segmentCount > 0)
+            this->renderSegments(frame);
+        else if (this->layerCount > 0)
+            this->renderLayers(frame);
+        else if (this->transitionFrom >= 0)
+            this->renderTransition(frame);
+        else if (this->validEffect(this->activeEffect))
+            this->runEffect(this->activeEffect, frame);
+        this->rendering = false;
+    }
+
+    /**
+     * @brief Queue a command to be applied by the render task at the start of the next frame
+     *
+     * @param command the command to queue
+     * @return false if the queue is full and the command was dropped
+     */
+    bool LedLib::post(const LedCommand &command)
+    {
+        return this->commands.push(command);
+    }
+
+    bool LedLib::postActiveEffect(int active)
+    {
+        return this->post({LedCommand::SetActiveEffect, 0, static_cast<int16_t>(active), 0, 0});
+    }
+
+    bool LedLib::postActiveEffect(int active, uint32_t duration, Easing curve)
+    {
+        return this->post({LedCommand::SetActiveEffect, 0, static_cast<int16_t>(active), static_cast<int32_t>(duration), static_cast<uint32_t>(curve)});
+    }
+
+    bool LedLib::postPixel(Color color, uint8_t index)
+    {
+        return this->post({LedCommand::SetPixel, index, 0, 0, color.value});
+    }
+
+    bool LedLib::postAll(Color color)
+    {
+        return this->post({LedCommand::SetAll, 0, 0, 0, color.value});
+    }
+
+    bool LedLib::postParam(int effect, int param, int32_t value)
+    {
+        return this->post({LedCommand::SetParam, 0, static_cast<int16_t>(effect), param, static_cast<uint32_t>(value)});
+    }
+
+    bool LedLib::postLayerOpacity(int layer, uint8_t opacity)
+    {
+        return this->post({LedCommand::SetLayerOpacity, 0, static_cast<int16_t>(layer), 0, opacity});
+    }
+
+    bool LedLib::postSegmentEffect(int segment, int effect)
+    {
+        return this->post({LedCommand::SetSegmentEffect, static_cast<uint8_t>(segment), static_cast<int16_t>(effect), 0, 0});
+    }
+
+    bool LedLib::postSegmentBrightness(int segment, uint8_t brightness)
+    {
+        return this->post({LedCommand::SetSegmentBrightness, static_cast<uint8_t>(segment), 0, 0, brightness});
+    }
+
+    /**
+     * @brief Apply every queued command
+     */
+    void LedLib::processCommands()
+    {
+        LedCommand command;
+        while (this->commands.pop(command))
+        {
+            switch (command.type)
+            {
+            case LedCommand::SetActiveEffect:
+                this->setActiveEffect(command.effect, command.param, static_cast<Easing>(command.value));
+                break;
+            case LedCommand::SetPixel:
+                if (command.index < this->size)
+                    this->writePixel(command.index, command.value);
+                break;
+            case LedCommand::SetAll:
+                this->fill(command.value);
+                break;
+            case LedCommand::Clear:
+                this->clear();
+                break;
+            case LedCommand::SetParam:
+                if (this->validEffect(command.effect))
+                    this->effects[command.effect]->setParam(command.param, static_cast<int32_t>(command.value));
+                break;
+            case LedCommand::SetLayerOpacity:
+                this->setLayerOpacity(command.effect, command.value);
+                break;
+            case LedCommand::SetSegmentEffect:
+                this->setSegmentEffect(command.index, command.effect);
+                break;
+            case LedCommand::SetSegmentBrightness:
+                this->setSegmentBrightness(command.index, command.value);
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Stack an effect on top of the existing layers
+     *
+     * @param effect the index returned by addEffect
+     * @param mode how the layer combines with the layers below
+     * @param opacity 0-255 strength of the layer
+     * @return The index of the new layer, or -1 if MAX_LAYERS is reached
+     */
+    int LedLib::addLayer(int effect, BlendMode mode, uint8_t opacity)
+    {
+        if (this->layerCount >= MAX_LAYERS)
+        {
+            LEDLIB_LOG_WARN("addLayer: already at %d layers", MAX_LAYERS);
+            return -1;
+        }
+        this->allocateScratch();
+        this->cancelTransition();
+        // The first layer replaces the active effect. Behind segments neither is rendered, so neither changes.
+        bool shown = this->segmentCount == 0;
+        if (shown && this->layerCount == 0 && this->validEffect(this->activeEffect))
+            this->effects[this->activeEffect]->onDeactivate(*this);
+        this->layers[this->layerCount] = {effect, mode, opacity};
+        if (shown && this->validEffect(effect))
+            this->effects[effect]->onActivate(*this);
+        return this->layerCount++;
+    }
+
+    /**
+     * @brief Change the strength of a layer
+     */
+    void LedLib::setLayerOpacity(int layer, uint8_t opacity)
+    {
+        if (layer >= 0 && layer < this->layerCount)
+            this->layers[layer].opacity = opacity;
+    }
+
+    /**
+     * @brief Change how a layer combines with the layers below
+     */
+    void LedLib::setLayerMode(int layer, BlendMode mode)
+    {
+        if (layer >= 0 && layer < this->layerCount)
+            this->layers[layer].mode = mode;
+    }
+
+    /**
+     * @brief Remove every layer, going back to rendering activeEffect
+     */
+    void LedLib::clearLayers()
+    {
+        // Behind segments the layers aren't active, and the active effect stays hidden
+        bool shown = this->segmentCount == 0 && this->layerCount > 0;
+        if (shown)
+            this->setBaseActive(false);
+        this->layerCount = 0;
+        if (shown)
+            this->setBaseActive(true);
+    }
+
+    /**
+     * @brief Split off a range of the strip to run its own effect
+     *
+     * @param name a name for findSegment, must outlive the LedLib
+     * @param start the index of the first LED
+     * @param length the number of LEDs
+     * @param effect the index returned by addEffect, -1 for none yet
+     * @return The index of the new segment, or -1 if MAX_SEGMENTS is reached
+     */
+    int LedLib::addSegment(const char *name, int start, int length, int effect)
+    {
+        if (this->segmentCount >= MAX_SEGMENTS)
+        {
+            LEDLIB_LOG_WARN("addSegment: already at %d segments", MAX_SEGMENTS);
+            return -1;
+        }
+        // Dimmed segments render through the compose buffer
+        this->allocateScratch();
+        this->cancelTransition();
+        // The first segment replaces the layers or the active effect
+        if (this->segmentCount == 0)
+            this->setBaseActive(false);
+        this->segments[this->segmentCount] = {name, start, length, -1, 0, 255, 0};
+        int segment = this->segmentCount++;
+        this->setSegmentEffect(segment, effect);
+        return segment;
+    }
+
+    /**
+     * @brief Look a segment up by name
+     *
+     * @return The index of the segment, or -1 if there is none with that name
+     */
+    int LedLib::findSegment(const char *name) const
+    {
+        for (int i = 0; i < this->segmentCount; i++)
+        {
+            if (this->segments[i].name != nullptr && std::strcmp(this->segments[i].name, name) == 0)
+                return i;
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Change the effect a segment runs, -1 for none
+     */
+    void LedLib::setSegmentEffect(int segment, int effect)
+    {
+        if (segment < 0 || segment >= this->segmentCount)
+            return;
+        Segment &current = this->segments[segment];
+        if (current.effect == effect)
+            return;
+        if (this->validEffect(current.effect))
+            this->effects[current.effect]->onDeactivate(*this);
+        current.effect = effect;
+        // A new effect starts from its own beginning, so owes the whole phase
+        current.lead = current.phase;
+        if (this->validEffect(effect))
+            this->effects[effect]->onActivate(*this);
+    }
+
+    /**
+     * @brief Run a segment's effect ahead of the strip
+     */
+    void LedLib::setSegmentPhase(int segment, uint32_t phase)
+    {
+        if (segment < 0 || segment >= this->segmentCount)
+            return;
+        Segment &current = this->segments[segment];
+        if (phase > current.phase)
+            current.lead += phase - current.phase;
+        current.phase = phase;
+    }
+
+    /**
+     * @brief Dim a segment
+     */
+    void LedLib::setSegmentBrightness(int segment, uint8_t brightness)
+    {
+        if (segment >= 0 && segment < this->segmentCount)
+            this->segments[segment].brightness = brightness;
+    }
+
+    /**
+     * @brief Remove every segment, going back to rendering the layers or activeEffect
+     */
+    void LedLib::clearSegments()
+    {
+        for (int i = 0; i < this->segmentCount; i++)
+        {
+            if (this->validEffect(this->segments[i].effect))
+                this->effects[this->segments[i].effect]->onDeactivate(*this);
+        }
+        if (this->segmentCount == 0)
+            return;
+        this->segmentCount = 0;
+        this->setBaseActive(true);
+    }
+
+    /**
+     * @brief Activate or deactivate what renders when there are no segments: the layers, or else the active effect
+     */
+    void LedLib::setBaseActive(bool active)
+    {
+        if (this->layerCount == 0)
+        {
+            if (!this->validEffect(this->activeEffect))
+                return;
+            if (active)
+                this->effects[this->activeEffect]->onActivate(*this);
+            else
+                this->effects[this->activeEffect]->onDeactivate(*this);
+            return;
+        }
+        for (int i = 0; i < this->layerCount; i++)
+        {
+            if (!this->validEffect(this->layers[i].effect))
+                continue;
+            if (active)
+                this->effects[this->layers[i].effect]->onActivate(*this);
+            else
+                this->effects[this->layers[i].effect]->onDeactivate(*this);
+        }
+    }
+
+    /**
+     * @brief Render every segment into its range of the frame buffer
+     *
+     * While a segment renders, size is its length and target points at its first LED, so the effect can't tell
+     * it isn't drawing a whole strip. Full brightness segments draw straight into the frame buffer; dimmed ones
+     * draw into the same range of the compose buffer and are scaled across, so an effect that only redraws some
+     * pixels doesn't compound the dimming.
+     */
+    void LedLib::renderSegments(const FrameContext &frame)
+    {
+        int stripSize = this->size;
+        for (int i = 0; i < this->segmentCount; i++)
+        {
+            Segment &segment = this->segments[i];
+            int start = std::max(segment.start, 0);
+            int end = std::min(segment.start + segment.length, stripSize);
+            if (start >= end || !this->validEffect(segment.effect))
+                continue;
+
+            // Time-driven effects see the phase on every frame, delta-driven ones catch up on it once
+            FrameContext shifted = frame;
+            shifted.time += segment.phase;
+            shifted.delta += segment.lead;
+            segment.lead = 0;
+            bool dimmed = segment.brightness != 255;
+            this->size = end - start;
+            this->targetOffset = start;
+            this->target = (dimmed ? this->composeBuffer.data() : this->buffer.data()) + start;
+            this->runEffect(segment.effect, shifted);
+            this->size = stripSize;
+            this->targetOffset = 0;
+            this->target = this->buffer.data();
+
+            if (dimmed)
+            {
+                const Color *rendered = this->composeBuffer.data();
+                uint8_t brightness = segment.brightness;
+                this->generate([rendered, brightness](int index)
+                               { return rendered[index].scale(brightness); },
+                               start, end - start);
+            }
+        }
+    }
+
+    /**
+     * @brief Composite the layer stack into the frame buffer
+     *
+     * The first opaque Normal layer renders straight into the compose buffer. Every other layer renders into
+     * the layer buffer and is blended down in a single pass. Finally the result is copied into the frame
+     * buffer, where only pixels that differ from the last frame are marked dirty.
+     */
+    void LedLib::renderLayers(const FrameContext &frame)
+    {
+        Color *compose = this->composeBuffer.data();
+        std::fill(this->composeBuffer.begin(), this->composeBuffer.end(), Color());
+        for (int i = 0; i < this->layerCount; i++)
+        {
+            const Layer &layer = this->layers[i];
+            if (layer.opacity == 0 || !this->validEffect(layer.effect))
+                continue;
+            if (i == 0 && layer.mode == BlendMode::Normal && layer.opacity == 255)
+            {
+                this->renderInto(compose, layer.effect, frame);
+                continue;
+            }
+            std::fill(this->layerBuffer.begin(), this->layerBuffer.end(), Color());
+            this->renderInto(this->layerBuffer.data(), layer.effect, frame);
+            Blend::row(compose, this->layerBuffer.data(), this->size, layer.mode, layer.opacity);
+        }
+        this->setPixels(compose, this->size);
+    }
+
+    /**
+     * @brief Render both sides of a crossfade and blend them into the frame buffer
+     *
+     * The fade is timed from the first frame rendered after it was requested, so a queued transition
+     * doesn't lose time waiting for the frame boundary.
+     */
+    void LedLib::renderTransition(const FrameContext &frame)
+    {
+        if (!this->transitionStarted)
+        {
+            // Both sides start from what is on the strip, for effects that only redraw some pixels
+            std::copy(this->buffer.begin(), this->buffer.end(), this->composeBuffer.begin());
+            std::copy(this->buffer.begin(), this->buffer.end(), this->layerBuffer.begin());
+            this->transitionStart = frame.time;
+            this->transitionStarted = true;
+        }
+        uint32_t elapsed = frame.time - this->transitionStart;
+        if (elapsed >= this->transitionDuration || !this->validEffect(this->activeEffect))
+        {
+            // Done: the outgoing effect is never updated again
+            this->cancelTransition();
+            if (this->validEffect(this->activeEffect))
+                this->runEffect(this->activeEffect, frame);
+            return;
+        }
+
+        uint8_t amount = Blend::ease(this->transitionCurve, static_cast<uint64_t>(elapsed) * 255 / this->transitionDuration);
+        Color *outgoing = this->composeBuffer.data();
+        Color *incoming = this->layerBuffer.data();
+        this->renderInto(outgoing, this->transitionFrom, frame);
+        this->renderInto(incoming, this->activeEffect, frame);
+        Blend::row(outgoing, incoming, this->size, BlendMode::Normal, amount);
+        this->setPixels(outgoing, this->size);
+    }
+
+    bool LedLib::validEffect(int effect) const
+    {
+        return effect >= 0 && effect < this->effectCount;
+    }
+
+    /**
+     * @brief Allocate the two scratch frames shared by layers, segments and transitions, once
+     */
+    void LedLib::allocateScratch()
+    {
+        if (!this->composeBuffer.empty())
             return;
-        if (effects.size() <= 0)
+        this->composeBuffer.resize(this->size);
+        this->layerBuffer.resize(this->size);
+    }
+
+    /**
+     * @brief Run an effect with setPixel and friends pointed at another buffer
+     */
+    void LedLib::renderInto(Color *destination, int effect, const FrameContext &frame)
+    {
+        this->target = destination;
+        this->runEffect(effect, frame);
+        this->target = this->buffer.data();
+    }
+
+    /**
+     * @brief Update one effect, timing it against its render budget if it declares one
+     */
+    void LedLib::runEffect(int effect, const FrameContext &frame)
+    {
+        LedEffect *current = this->effects[effect];
+        uint32_t budget = current->renderBudget();
+        if (budget == 0)
+        {
+            current->update(*this, frame);
             return;
-        LedEffect *effect = this->effects[this->activeEffect];
-        effect->update(*this);
-        return;
+        }
+        uint64_t started = pros::micros();
+        current->update(*this, frame);
+        uint32_t elapsed = pros::micros() - started;
+        // Budgets are given per 64 LEDs, so scale to the strip, but not so far that timing overhead alone exceeds it
+        uint64_t allowed = static_cast<uint64_t>(budget) * this->size / 64;
+        if (allowed < MIN_RENDER_BUDGET)
+            allowed = MIN_RENDER_BUDGET;
+        if (elapsed <= allowed)
+        {
+            this->overrunning[effect] = false;
+            return;
+        }
+        this->frameStats.overBudget++;
+        if (!this->overrunning[effect])
+            LEDLIB_LOG_WARN("effect %d took %u us, over its budget of %u us", effect, static_cast<unsigned>(elapsed),
+                            static_cast<unsigned>(allowed));
+        this->overrunning[effect] = true;
     }
 
     /// Static Functions
@@ -213,73 +1147,15 @@ namespace LedLib
 
     /**
      * @brief Converts HSV to RGB
-     * @note Credits: https://stackoverflow.com/questions/51203917/math-behind-hsv-to-rgb-conversion-of-colors
+     *
+     * @note Scales to the fixed point ring and goes through HSVtoUINT32(uint16_t, uint8_t, uint8_t), so there is no fmod or floor per pixel
      *
      * @param hsv The HSV struct to convert from
      * @return A HSV struct
      */
     RGB LedLib::HSVtoRGB(HSV hsv)
     {
-        double h = hsv.hue;                // 0-360
-        double s = hsv.saturation / 100.0; // 0-100 mapping to 0-1
-        double v = hsv.value / 100.0;      // 0-100 mapping to 0-1
-
-        // Normalize hue to [0, 360]
-        h = std::fmod(h, 360.0);
-        if (h < 0)
-            h += 360.0;
-
-        int hi = static_cast<int>(std::floor(h / 60.0)) % 6;
-        double f = (h / 60.0) - static_cast<int>(h / 60.0);
-        double p = v * (1.0 - s);
-        double q = v * (1.0 - f * s);
-        double t = v * (1.0 - (1.0 - f) * s);
-
-        double r, g, b;
-
-        switch (hi)
-        {
-        case 0:
-            r = v;
-            g = t;
-            b = p;
-            break;
-        case 1:
-            r = q;
-            g = v;
-            b = p;
-            break;
-        case 2:
-            r = p;
-            g = v;
-            b = t;
-            break;
-        case 3:
-            r = p;
-            g = q;
-            b = v;
-            break;
-        case 4:
-            r = t;
-            g = p;
-            b = v;
-            break;
-        case 5:
-            r = v;
-            g = p;
-            b = q;
-            break;
-        default:
-            r = g = b = 0.0;
-            break;
-        }
-
-        // Scale to [0, 255] and convert to int
-        RGB result;
-        result.red = static_cast<int>(r * 255);
-        result.green = static_cast<int>(g * 255);
-        result.blue = static_cast<int>(b * 255);
-        return result;
+        return UINT32toRGB(HSVtoUINT32(hsv));
     }
 
     /**
@@ -342,24 +1218,10 @@ namespace LedLib
      */
     uint32_t LedLib::RGBtoUINT32(RGB rgb)
     {
-        if (rgb.red > 255)
-        {
-            rgb.red = 255;
-            std::cout << "[DEBUG FA/CLRCHK] R>255";
-        }
-        if (rgb.green > 255)
-        {
-            rgb.green = 255;
-            std::cout << "[DEBUG FA/CLRCHK] G>255";
-        }
-        if (rgb.blue > 255)
-        {
-            rgb.blue = 255;
-            std::cout << "[DEBUG FA/CLRCHK] B>255";
-        }
-        // Shifts Red 16 bits to the right, Green 8 bits to the right, and Blue 0 bits to the right
-        // Then adds them together
-        return ((uint8_t)rgb.red << 16) | ((uint8_t)rgb.green << 8) | (uint8_t)rgb.blue;
+        if (rgb.red > 255 || rgb.green > 255 || rgb.blue > 255)
+            LEDLIB_LOG_DEBUG("CLRCHK clamped R%d G%d B%d", rgb.red, rgb.green, rgb.blue);
+        // Packs Red into bits 16-23, Green into 8-15 and Blue into 0-7, clamping each to 0-255
+        return Color::fromRGB(rgb).value;
     }
 
     /**
@@ -370,7 +1232,86 @@ namespace LedLib
      */
     uint32_t LedLib::HSVtoUINT32(HSV hsv)
     {
-        return RGBtoUINT32(HSVtoRGB(hsv));
+        // Hues outside one turn are wrapped in floating point first, since scaling a huge one overflows the cast
+        double degrees = hsv.hue;
+        if (!(degrees >= 0.0 && degrees < 360.0))
+        {
+            degrees = std::fmod(degrees, 360.0);
+            if (degrees < 0.0)
+                degrees += 360.0;
+            else if (!(degrees >= 0.0))
+                degrees = 0.0; // NaN or infinite
+        }
+        // 0-360 degrees to 0-1535. A hue that rounds up to 360 is wrapped by fromHSV.
+        uint16_t hue = static_cast<uint16_t>(degrees * (Color::HUE_RING / 360.0));
+        return HSVtoUINT32(hue, percentTo255(hsv.saturation), percentTo255(hsv.value));
+    }
+
+    /**
+     * @brief Look up a fully saturated rainbow color from Tables::rainbow
+     *
+     * @param hue 0-255 around the color wheel
+     * @return A Color
+     */
+    Color LedLib::rainbow(uint8_t hue)
+    {
+        return Tables::rainbow[hue];
+    }
+
+    /**
+     * @brief Gamma correct each channel of a color through Tables::gamma
+     *
+     * @param color the color to correct
+     * @return The corrected color
+     */
+    Color LedLib::gammaCorrect(Color color)
+    {
+        return Color(Tables::gamma[color.red()], Tables::gamma[color.green()], Tables::gamma[color.blue()]);
+    }
+
+    /**
+     * @brief Table driven sine, mirroring Tables::quarterSine into the other three quadrants
+     *
+     * @param theta 0-255 representing one full turn
+     * @return 1-255, centered on 128
+     */
+    uint8_t LedLib::sin8(uint8_t theta)
+    {
+        uint8_t step = theta & 0x3F;
+        switch (theta >> 6)
+        {
+        case 0:
+            return 128 + Tables::quarterSine[step];
+        case 1:
+            return 128 + Tables::quarterSine[64 - step];
+        case 2:
+            return 128 - Tables::quarterSine[step];
+        default:
+            return 128 - Tables::quarterSine[64 - step];
+        }
+    }
+
+    /**
+     * @brief Table driven cosine
+     *
+     * @param theta 0-255 representing one full turn
+     * @return 1-255, centered on 128
+     */
+    uint8_t LedLib::cos8(uint8_t theta)
+    {
+        return sin8(theta + 64);
+    }
+
+    /**
+     * @brief Maps a 0-100 HSV percentage to 0-255, clamping anything out of range
+     */
+    uint8_t LedLib::percentTo255(double percent)
+    {
+        if (percent <= 0)
+            return 0;
+        if (percent >= 100)
+            return 255;
+        return static_cast<uint8_t>(percent * 2.55 + 0.5);
     }
 
 }
\ No newline at end of file
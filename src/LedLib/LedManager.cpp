@@ -0,0 +1,158 @@
+#include "LedManager.hpp"
+#include "Log.hpp"
+namespace LedLib
+{
+    /**
+     * @brief Stop the render task if it is still running
+     */
+    LedManager::~LedManager()
+    {
+        this->stop();
+    }
+
+    /**
+     * @brief Add a strip to be driven by this manager
+     *
+     * @param strip the strip
+     * @return The index of the strip, or -1 if MAX_STRIPS are already added or the manager is running
+     */
+    int LedManager::addStrip(LedLib *strip)
+    {
+        if (this->running)
+        {
+            LEDLIB_LOG_ERROR("LedManager: addStrip while running");
+            return -1;
+        }
+        if (this->count >= MAX_STRIPS)
+        {
+            LEDLIB_LOG_ERROR("LedManager: already at %d strips", MAX_STRIPS);
+            return -1;
+        }
+        if (strip->isRunning())
+            LEDLIB_LOG_WARN("LedManager: strip %d has its own render task, stop it first", this->count);
+        this->strips[this->count] = strip;
+        return this->count++;
+    }
+
+    /**
+     * @brief The number of strips added
+     */
+    int LedManager::stripCount() const
+    {
+        return this->count;
+    }
+
+    /**
+     * @brief Get a strip by the index returned by addStrip
+     *
+     * @return The strip, or nullptr if index is out of range
+     */
+    LedLib *LedManager::strip(int index) const
+    {
+        if (index < 0 || index >= this->count)
+            return nullptr;
+        return this->strips[index];
+    }
+
+    /**
+     * @brief Render every strip once and commit them back to back
+     */
+    void LedManager::update()
+    {
+        for (int i = 0; i < this->count; i++)
+            this->strips[i]->render();
+        for (int i = 0; i < this->count; i++)
+            this->strips[i]->commit();
+    }
+
+    /**
+     * @brief Start a task that renders and commits every strip at a fixed frame rate
+     *
+     * @param fps 1-1000 frames per second. The period is rounded down to whole milliseconds.
+     * @param mode how the commits of the strips are spaced out
+     * @param priority the priority of the render task
+     */
+    void LedManager::start(uint32_t fps, CommitMode mode, uint32_t priority)
+    {
+        if (this->running)
+            return;
+        if (fps < 1)
+            fps = 1;
+        if (fps > 1000)
+            fps = 1000;
+        this->framePeriod = 1000 / fps;
+        this->mode = mode;
+        // Fades posted to a strip must not allocate on this task
+        for (int i = 0; i < this->count; i++)
+            this->strips[i]->prepare();
+        this->running = true;
+        Log::start();
+        this->renderTask = std::make_unique<pros::Task>([this]
+                                                        { this->renderLoop(); },
+                                                        priority, TASK_STACK_DEPTH_DEFAULT, "LedLib Manager");
+    }
+
+    /**
+     * @brief Stop the render task, waiting for the frame in progress to finish
+     */
+    void LedManager::stop()
+    {
+        if (!this->running)
+            return;
+        this->running = false;
+        this->renderTask->join();
+        this->renderTask.reset();
+    }
+
+    /**
+     * @brief Whether the render task is running
+     */
+    bool LedManager::isRunning() const
+    {
+        return this->running;
+    }
+
+    /**
+     * @brief Reset the frame counters here and the counters of every strip
+     */
+    void LedManager::resetStats()
+    {
+        this->frameStats = LedLib::FrameStats();
+        for (int i = 0; i < this->count; i++)
+            this->strips[i]->resetStats();
+    }
+
+    /**
+     * @brief Body of the render task
+     *
+     * In Stagger mode strip i is rendered and committed i/N of the way through the frame, so the ADI writes are
+     * evenly spaced and each strip's frame is as fresh as possible when it goes out. Late frames are handled by
+     * FrameStats::endFrame, as in LedLib::renderLoop.
+     */
+    void LedManager::renderLoop()
+    {
+        uint32_t wake = pros::millis();
+        while (this->running)
+        {
+            uint32_t frameStart = wake;
+            if (this->mode == CommitMode::Batch || this->count < 2)
+            {
+                this->update();
+            }
+            else
+            {
+                for (int i = 0; i < this->count; i++)
+                {
+                    if (i > 0)
+                    {
+                        uint32_t slot = frameStart;
+                        pros::Task::delay_until(&slot, this->framePeriod * i / this->count);
+                    }
+                    this->strips[i]->render();
+                    this->strips[i]->commit();
+                }
+            }
+            this->frameStats.endFrame(wake, this->framePeriod);
+        }
+    }
+};
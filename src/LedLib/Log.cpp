@@ -0,0 +1,91 @@
+#include "Log.hpp"
+#include "MpscQueue.hpp"
+#include <cstdarg>
+#include <cstdio>
+namespace LedLib
+{
+    namespace
+    {
+        struct LogEntry
+        {
+            uint32_t time;
+            Log::Level level;
+            char text[59];
+        };
+
+        MpscQueue<LogEntry, 32> entries;
+        std::atomic<uint32_t> droppedCount{0};
+        std::atomic<bool> flushing{false};
+
+        const char *levelName(Log::Level level)
+        {
+            switch (level)
+            {
+            case Log::Error:
+                return "ERROR";
+            case Log::Warn:
+                return "WARN";
+            case Log::Info:
+                return "INFO";
+            default:
+                return "DEBUG";
+            }
+        }
+    }
+
+    /**
+     * @brief Format a message and queue it for the flush task
+     *
+     * @param level the severity of the message
+     * @param format a printf style format string, truncated to fit one entry
+     */
+    void Log::write(Level level, const char *format, ...)
+    {
+        LogEntry entry;
+        entry.time = pros::millis();
+        entry.level = level;
+        va_list args;
+        va_start(args, format);
+        vsnprintf(entry.text, sizeof(entry.text), format, args);
+        va_end(args);
+        if (!entries.push(entry))
+            droppedCount++;
+    }
+
+    /**
+     * @brief Start the task that prints queued messages
+     *
+     * @param priority the priority of the flush task
+     */
+    void Log::start(uint32_t priority)
+    {
+        if (flushing.exchange(true))
+            return;
+        pros::Task([]
+                   {
+                       while (true)
+                       {
+                           flush();
+                           pros::delay(20);
+                       } },
+                   priority, TASK_STACK_DEPTH_DEFAULT, "LedLib Log");
+    }
+
+    /**
+     * @brief Print every queued message now
+     */
+    void Log::flush()
+    {
+        LogEntry entry;
+        while (entries.pop(entry))
+            printf("[LedLib %s %lu] %s\n", levelName(entry.level), static_cast<unsigned long>(entry.time), entry.text);
+    }
+
+    /**
+     * @brief The number of messages dropped because the queue was full
+     */
+    uint32_t Log::dropped()
+    {
+        return droppedCount;
+    }
+};
@@ -0,0 +1,155 @@
+#include "Noise.hpp"
+#include <array>
+namespace LedLib
+{
+    namespace Noise
+    {
+        namespace
+        {
+            /// Ken Perlin's reference permutation of 0-255
+            constexpr uint8_t permutation[256] = {
+            151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+            140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+            247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+            57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+            74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+            60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+            65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+            200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+            52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+            207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+            119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+            129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+            218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+            81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+            184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+            222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180,
+            };
+
+            /// 6t^5 - 15t^4 + 10t^3 for t = i / 256, scaled to 0-256
+            constexpr std::array<uint16_t, 256> makeFadeTable()
+            {
+                std::array<uint16_t, 256> table{};
+                for (int i = 0; i < 256; i++)
+                {
+                    int64_t t = i;
+                    // Exact in integers: t^3 (6t^2 - 15 * 256t + 10 * 256^2) / 256^4, scaled by 256
+                    int64_t value = t * t * t * (6 * t * t - 15 * 256 * t + 10 * 256 * 256);
+                    table[i] = static_cast<uint16_t>((value + (INT64_C(1) << 31)) >> 32);
+                }
+                return table;
+            }
+
+            constexpr std::array<uint16_t, 256> fade = makeFadeTable();
+
+            inline uint8_t hash(uint8_t i)
+            {
+                return permutation[i];
+            }
+
+            inline int32_t lerp(int32_t a, int32_t b, int32_t t)
+            {
+                return a + (((b - a) * t) >> 8);
+            }
+
+            /// Gradient of magnitude 1-8 in either direction, dotted with dx
+            inline int32_t grad(uint8_t hash, int32_t dx)
+            {
+                int32_t magnitude = (hash & 7) + 1;
+                return (hash & 8) ? -magnitude * dx : magnitude * dx;
+            }
+
+            /// One of the four diagonal gradients, dotted with (dx, dy)
+            inline int32_t grad(uint8_t hash, int32_t dx, int32_t dy)
+            {
+                return ((hash & 1) ? -dx : dx) + ((hash & 2) ? -dy : dy);
+            }
+
+            /// Perlin's twelve edge gradients, padded to 16 with repeats so a hash picks one with a mask
+            constexpr int8_t gradients[16][3] = {
+                {1, 1, 0}, {-1, 1, 0}, {1, -1, 0}, {-1, -1, 0},
+                {1, 0, 1}, {-1, 0, 1}, {1, 0, -1}, {-1, 0, -1},
+                {0, 1, 1}, {0, -1, 1}, {0, 1, -1}, {0, -1, -1},
+                {1, 1, 0}, {0, -1, 1}, {-1, 1, 0}, {0, -1, -1}};
+
+            /// One of the edge gradients, dotted with (dx, dy, dz). Multiplies instead of branches.
+            inline int32_t grad(uint8_t hash, int32_t dx, int32_t dy, int32_t dz)
+            {
+                const int8_t *g = gradients[hash & 15];
+                return g[0] * dx + g[1] * dy + g[2] * dz;
+            }
+        }
+
+        /**
+         * @brief 1D noise
+         *
+         * @param x 8.8 fixed point coordinate
+         * @return -256 to 256, 0 on every lattice point
+         */
+        int16_t perlin(uint32_t x)
+        {
+            uint8_t cell = x >> 8;
+            int32_t dx = x & 0xFF;
+            int32_t value = lerp(grad(hash(cell), dx), grad(hash(cell + 1), dx - 256), fade[dx]);
+            // Gradients go up to 8 and the largest value is 8 * 128, halfway between lattice points
+            return value >> 2;
+        }
+
+        /**
+         * @brief 2D noise
+         *
+         * @param x 8.8 fixed point coordinate
+         * @param y 8.8 fixed point coordinate
+         * @return about -256 to 256, 0 on every lattice point
+         */
+        int16_t perlin(uint32_t x, uint32_t y)
+        {
+            uint8_t cellX = x >> 8;
+            uint8_t cellY = y >> 8;
+            int32_t dx = x & 0xFF;
+            int32_t dy = y & 0xFF;
+            int32_t u = fade[dx];
+            int32_t v = fade[dy];
+
+            uint8_t a = hash(cellX) + cellY;
+            uint8_t b = hash(cellX + 1) + cellY;
+            int32_t bottom = lerp(grad(hash(a), dx, dy), grad(hash(b), dx - 256, dy), u);
+            int32_t top = lerp(grad(hash(a + 1), dx, dy - 256), grad(hash(b + 1), dx - 256, dy - 256), u);
+            return lerp(bottom, top, v);
+        }
+
+        /**
+         * @brief 3D noise
+         *
+         * @param x 8.8 fixed point coordinate
+         * @param y 8.8 fixed point coordinate
+         * @param z 8.8 fixed point coordinate
+         * @return about -256 to 256, 0 on every lattice point
+         */
+        int16_t perlin(uint32_t x, uint32_t y, uint32_t z)
+        {
+            uint8_t cellX = x >> 8;
+            uint8_t cellY = y >> 8;
+            uint8_t cellZ = z >> 8;
+            int32_t dx = x & 0xFF;
+            int32_t dy = y & 0xFF;
+            int32_t dz = z & 0xFF;
+            int32_t u = fade[dx];
+            int32_t v = fade[dy];
+            int32_t w = fade[dz];
+
+            uint8_t a = hash(cellX) + cellY;
+            uint8_t aa = hash(a) + cellZ;
+            uint8_t ab = hash(a + 1) + cellZ;
+            uint8_t b = hash(cellX + 1) + cellY;
+            uint8_t ba = hash(b) + cellZ;
+            uint8_t bb = hash(b + 1) + cellZ;
+
+            int32_t near = lerp(lerp(grad(hash(aa), dx, dy, dz), grad(hash(ba), dx - 256, dy, dz), u),
+                                lerp(grad(hash(ab), dx, dy - 256, dz), grad(hash(bb), dx - 256, dy - 256, dz), u), v);
+            int32_t far = lerp(lerp(grad(hash(aa + 1), dx, dy, dz - 256), grad(hash(ba + 1), dx - 256, dy, dz - 256), u),
+                               lerp(grad(hash(ab + 1), dx, dy - 256, dz - 256), grad(hash(bb + 1), dx - 256, dy - 256, dz - 256), u), v);
+            return lerp(near, far, w);
+        }
+    }
+};
@@ -0,0 +1,74 @@
+#include "Palette.hpp"
+#include "LedLib.hpp"
+namespace LedLib
+{
+    /**
+     * @brief Construct an all black palette
+     */
+    Palette256::Palette256()
+    {
+    }
+
+    /**
+     * @brief Construct by expanding a 16 color palette
+     *
+     * @param palette the palette to expand
+     * @param wrap blend the last entry back into the first
+     */
+    Palette256::Palette256(const Palette16 &palette, bool wrap)
+    {
+        this->load(palette, wrap);
+    }
+
+    /**
+     * @brief Expand a 16 color palette, interpolating 16 steps between neighbouring entries
+     *
+     * @param palette the palette to expand
+     * @param wrap blend the last entry back into the first
+     */
+    void Palette256::load(const Palette16 &palette, bool wrap)
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            if (wrap)
+            {
+                // Entry k sits at index 16k and blends toward entry k + 1 (15 wraps to 0)
+                int k = i >> 4;
+                this->entries[i] = Color::lerp(palette.entries[k], palette.entries[(k + 1) & 15], (i & 15) << 4);
+            }
+            else
+            {
+                // Stretch 15 gaps over 255 indices so entry 15 lands exactly on index 255
+                int position = i * 15;
+                int k = position / 255;
+                int fraction = (position % 255) * 256 / 255;
+                this->entries[i] = k >= 15 ? palette.entries[15] : Color::lerp(palette.entries[k], palette.entries[k + 1], fraction);
+            }
+        }
+    }
+
+    /**
+     * @brief Fill the palette with a straight RGB gradient
+     *
+     * @param start the color at index 0
+     * @param end the color at index 255
+     */
+    void Palette256::loadGradient(Color start, Color end)
+    {
+        for (int i = 0; i < 256; i++)
+            this->entries[i] = Color::lerp(start, end, i);
+        this->entries[255] = end;
+    }
+
+    /**
+     * @brief Fill the palette with a gradient that travels around the hue wheel
+     *
+     * @param start the color at index 0
+     * @param end the color at index 255
+     */
+    void Palette256::loadGradient(HSV start, HSV end)
+    {
+        for (int i = 0; i < 256; i++)
+            this->entries[i] = LedLib::HSVtoUINT32(LedLib::lerpHSV(start, end, i / 255.0));
+    }
+};
@@ -0,0 +1,29 @@
+#include "BreatheEffect.hpp"
+#include "LedLib/LedLib.hpp"
+#include "LedLib/Tables.hpp"
+#include "main.h"
+namespace LedLib {
+    BreatheEffect::BreatheEffect(Color color, uint16_t period, uint8_t floor)
+        : color(color), period(period), floor(floor) {}
+
+    void BreatheEffect::prepare(LedLib &ledLib, const FrameContext &frame) {
+        if (period == 0)
+            period = 1;
+        uint8_t phase = (frame.time % period) * 256 / period;
+        // Start each breath from the bottom of the wave
+        uint8_t level = Tables::gamma[LedLib::sin8(phase - 64)];
+        current = color.scale(floor + ((255 - floor) * level >> 8));
+    };
+
+    void BreatheEffect::setParam(int param, int32_t value) {
+        switch (param)
+        {
+        case Period:
+            period = value;
+            break;
+        case Floor:
+            floor = value;
+            break;
+        }
+    };
+}
@@ -0,0 +1,27 @@
+#include "ChaseEffect.hpp"
+#include "LedLib/LedLib.hpp"
+#include "main.h"
+namespace LedLib {
+    ChaseEffect::ChaseEffect(Color color, Color background, uint8_t length, int32_t speed)
+        : color(color), background(background), length(length), speed(speed) {}
+
+    void ChaseEffect::prepare(LedLib &ledLib, const FrameContext &frame) {
+        stripSize = ledLib.size > 0 ? ledLib.size : 1;
+        int32_t wrap = stripSize << 8;
+        head = (head + static_cast<int32_t>(frame.delta) * speed) % wrap;
+        if (head < 0)
+            head += wrap;
+    };
+
+    void ChaseEffect::setParam(int param, int32_t value) {
+        switch (param)
+        {
+        case Speed:
+            speed = value;
+            break;
+        case Length:
+            length = value;
+            break;
+        }
+    };
+}
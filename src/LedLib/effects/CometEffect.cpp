@@ -0,0 +1,28 @@
+#include "CometEffect.hpp"
+#include "LedLib/LedLib.hpp"
+#include "main.h"
+namespace LedLib {
+    CometEffect::CometEffect(Color color, uint8_t tail, int32_t speed)
+        : color(color), tail(tail), speed(speed) {}
+
+    void CometEffect::prepare(LedLib &ledLib, const FrameContext &frame) {
+        stripSize = ledLib.size > 0 ? ledLib.size : 1;
+        wrap = stripSize << 8;
+        tailLength = (tail > 0 ? tail : 1) << 8;
+        fade = (255 << 16) / tailLength;
+        int32_t step = static_cast<int32_t>(frame.delta) * (speed < 0 ? -speed : speed);
+        head = (head + step) % wrap;
+    };
+
+    void CometEffect::setParam(int param, int32_t value) {
+        switch (param)
+        {
+        case Speed:
+            speed = value;
+            break;
+        case Tail:
+            tail = value;
+            break;
+        }
+    };
+}
@@ -0,0 +1,153 @@
+#include "FireEffect.hpp"
+#include <algorithm>
+#include "LedLib/LedLib.hpp"
+#include "main.h"
+namespace LedLib {
+    namespace
+    {
+        /// Shared by every FireEffect without its own palette, so each instance doesn't carry 1 KB of colors
+        const Palette256 &heatPalette()
+        {
+            static const Palette256 palette(Palettes::Heat, false);
+            return palette;
+        }
+    }
+
+    FireEffect::FireEffect(uint8_t cooling, uint8_t sparking, uint32_t seed, bool reversed, const Palette256 *palette)
+        : cooling(cooling), sparking(sparking), reversed(reversed), palette(palette)
+    {
+        // xorshift gets stuck at 0, so scramble the seed and make sure it isn't
+        this->state = (seed * UINT32_C(0x9E3779B9)) | 1;
+    };
+
+    void FireEffect::setup(LedLib &ledLib)
+    {
+        if (this->palette == nullptr)
+            this->palette = &heatPalette();
+        this->reset(ledLib.size);
+    };
+
+    void FireEffect::onResize(LedLib &ledLib)
+    {
+        this->reset(ledLib.size);
+    };
+
+    void FireEffect::update(LedLib &ledLib, const FrameContext &frame)
+    {
+        if (this->heatSize != std::min(ledLib.size, MAX_CELLS))
+            this->reset(ledLib.size);
+        if (this->heatSize == 0)
+            return;
+
+        // Step the simulation at a fixed rate, catching up at most a few steps after a stall
+        this->pending += frame.delta;
+        if (this->pending > 4 * STEP)
+            this->pending = 4 * STEP;
+        if (frame.frame == 0)
+            this->pending = STEP;
+        while (this->pending >= STEP)
+        {
+            this->step();
+            this->pending -= STEP;
+        }
+
+        const uint8_t *levels = this->heat.data();
+        const Palette256 &colors = *this->palette;
+        int count = this->heatSize;
+        int last = count - 1;
+        if (this->reversed)
+            ledLib.generate([levels, &colors, last](int index)
+                            { return colors[levels[last - index]]; },
+                            0, count);
+        else
+            ledLib.generate([levels, &colors](int index)
+                            { return colors[levels[index]]; },
+                            0, count);
+    };
+
+    /**
+     * @brief Put the fire out and size it for a strip
+     */
+    void FireEffect::reset(int size)
+    {
+        this->heatSize = std::max(0, std::min(size, MAX_CELLS));
+        this->heat.fill(0);
+    }
+
+    /**
+     * @brief Advance the heat simulation by one step
+     */
+    void FireEffect::step()
+    {
+        int size = this->heatSize;
+        uint8_t *cells = this->heat.data();
+
+        // Cool every cell a little, more on short strips so the flames stay in proportion
+        int maxCooling = ((this->cooling * 10) / size) + 2;
+        if (maxCooling > 255)
+            maxCooling = 255;
+        uint32_t bits = 0;
+        for (int i = 0; i < size; i++)
+        {
+            // One xorshift step gives the random bytes for four cells
+            if ((i & 3) == 0)
+                bits = this->next();
+            uint8_t cool = ((bits & 0xFF) * maxCooling) >> 8;
+            bits >>= 8;
+            cells[i] = cells[i] > cool ? cells[i] - cool : 0;
+        }
+
+        // Heat drifts up and diffuses. (a + 2b) / 3 as a multiply, 85/256 being just under 1/3.
+        for (int i = size - 1; i >= 2; i--)
+            cells[i] = ((cells[i - 1] + 2 * cells[i - 2]) * 85) >> 8;
+
+        // Randomly ignite a spark near the base
+        if (this->random8() < this->sparking)
+        {
+            int base = size < 7 ? size : 7;
+            int cell = this->random8(base);
+            uint16_t hotter = cells[cell] + 160 + this->random8(95);
+            cells[cell] = hotter > 255 ? 255 : hotter;
+        }
+    }
+
+    /**
+     * @brief Step the xorshift32 generator
+     */
+    uint32_t FireEffect::next()
+    {
+        this->state ^= this->state << 13;
+        this->state ^= this->state >> 17;
+        this->state ^= this->state << 5;
+        return this->state;
+    }
+
+    /**
+     * @brief A random byte
+     */
+    uint8_t FireEffect::random8()
+    {
+        return this->next() >> 24;
+    }
+
+    /**
+     * @brief A random number from 0 up to but not including limit, without a divide
+     */
+    uint8_t FireEffect::random8(uint8_t limit)
+    {
+        return (this->random8() * limit) >> 8;
+    }
+
+    void FireEffect::setParam(int param, int32_t value)
+    {
+        switch (param)
+        {
+        case Cooling:
+            this->cooling = value;
+            break;
+        case Sparking:
+            this->sparking = value;
+            break;
+        }
+    };
+}
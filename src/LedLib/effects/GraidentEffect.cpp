@@ -1,13 +1,12 @@
 // Include Effect
 #include "LedLib/effects/GraidentEffect.hpp"
 #include "LedLib/LedLib.hpp"
+#include "LedLib/Log.hpp"
 #include "main.h"
-using namespace std;
 namespace LedLib
 {
     GraidentEffect::GraidentEffect(RGB start, RGB end)
     {
-        std::cout << "hi";
         this->startColor = LedLib::RGBtoHSV(start);
         this->endColor = LedLib::RGBtoHSV(end);
     };
@@ -20,43 +19,53 @@ namespace LedLib
 
     void GraidentEffect::setup(LedLib &ledLib)
     {
-        return;
+        this->buildLut(ledLib.size);
     };
-    void GraidentEffect::update(LedLib &ledLib)
+
+    void GraidentEffect::onResize(LedLib &ledLib)
+    {
+        this->buildLut(ledLib.size);
+    };
+
+    void GraidentEffect::update(LedLib &ledLib, const FrameContext &frame)
     {
         if (ledLib.size < 1)
         {
             // Ensure the LED strip size is valid
-            std::cout << "LED strip size is less than 1." << std::endl;
+            LEDLIB_LOG_WARN("GraidentEffect: LED strip size is less than 1");
             return;
         }
 
-        // std::cout << "Updating gradient effect..." << std::endl;
+        // Only rebuild when the strip or the colors changed since the last build
+        if (this->lut.size() != static_cast<size_t>(ledLib.size) || !sameColor(this->startColor, this->builtStart) || !sameColor(this->endColor, this->builtEnd))
+            this->buildLut(ledLib.size);
+
+        // Unchanged pixels don't mark the frame dirty, so a static gradient never triggers a commit
+        ledLib.setPixels(this->lut.data(), this->lut.size());
+    }
 
-        for (int i = 0; i < ledLib.size; ++i)
+    /**
+     * @brief Interpolate the gradient once for every pixel of a strip of the given size
+     */
+    void GraidentEffect::buildLut(int size)
+    {
+        this->lut.resize(size);
+        RGB start = LedLib::HSVtoRGB(this->startColor);
+        RGB end = LedLib::HSVtoRGB(this->endColor);
+        for (int i = 0; i < size; ++i)
         {
             // Calculate the scale for interpolation
-            double scale = static_cast<double>(i) / (ledLib.size - 1);
-
-            // std::cout << "Interpolation scale: " << scale << std::endl;
-
-            // Interpolate between start and end colors
-            //HSV lerped = LedLib::lerpHSV(startColor, endColor, scale);
-            //std::cout << "LERPED: H" << lerped.hue << " S" << lerped.saturation << " V" << lerped.value << "\n";
-            // RGB interpolatedColor = LedLib::HSVtoRGB(lerped);
-            RGB startColor2 = LedLib::HSVtoRGB(startColor);
-            RGB endColor2 = LedLib::HSVtoRGB(endColor);
-            cout << " R" << startColor2.red << " G" << startColor2.green << " B"<< startColor2.blue;
-            cout << " R" << endColor2.red << " G" << endColor2.green << " B"<< endColor2.blue << endl;
-            RGB interpolatedColor = LedLib::lerpRGB(LedLib::HSVtoRGB(startColor), LedLib::HSVtoRGB(endColor), scale);
-            std::cout << "CONVERT: R" << interpolatedColor.red << " G" << interpolatedColor.green << " B" << interpolatedColor.blue << "\n";
-
-            // std::cout << "Interpolated color (RGB): R=" << interpolatedColor.red << ", G=" << interpolatedColor.green << ", B=" << interpolatedColor.blue << std::endl;
-
-            // Set the pixel color on the LED strip
-            ledLib.setPixel(interpolatedColor, i);
-            pros::delay(5);
+            double scale = size > 1 ? static_cast<double>(i) / (size - 1) : 0.0;
+            this->lut[i] = Color::fromRGB(LedLib::lerpRGB(start, end, scale));
         }
+        this->builtStart = this->startColor;
+        this->builtEnd = this->endColor;
+        LEDLIB_LOG_DEBUG("GraidentEffect: rebuilt LUT for %d pixels", size);
+    }
+
+    bool GraidentEffect::sameColor(const HSV &a, const HSV &b)
+    {
+        return a.hue == b.hue && a.saturation == b.saturation && a.value == b.value;
     }
 
-};
\ No newline at end of file
+};
@@ -0,0 +1,34 @@
+#include "LarsonEffect.hpp"
+#include "LedLib/LedLib.hpp"
+#include "main.h"
+namespace LedLib {
+    LarsonEffect::LarsonEffect(Color color, uint8_t width, uint16_t period, Color background)
+        : color(color), width(width), period(period), background(background) {}
+
+    void LarsonEffect::prepare(LedLib &ledLib, const FrameContext &frame) {
+        if (period < 2)
+            period = 2;
+        reach = (width > 0 ? width : 1) << 8;
+        fade = (255 << 16) / reach;
+        // Fold the time into a triangle wave so the eye runs out and back
+        uint32_t half = period / 2;
+        uint32_t t = frame.time % period;
+        uint32_t along = t < half ? t : period - t;
+        if (along > half)
+            along = half;
+        int32_t span = ledLib.size > 1 ? (ledLib.size - 1) << 8 : 0;
+        eye = static_cast<uint64_t>(along) * span / half;
+    };
+
+    void LarsonEffect::setParam(int param, int32_t value) {
+        switch (param)
+        {
+        case Period:
+            period = value;
+            break;
+        case Width:
+            width = value;
+            break;
+        }
+    };
+}
@@ -0,0 +1,36 @@
+#include "NoiseEffect.hpp"
+#include "LedLib/LedLib.hpp"
+#include "main.h"
+namespace LedLib {
+    namespace
+    {
+        /// Shared by every NoiseEffect without its own palette
+        const Palette256 &lavaPalette()
+        {
+            static const Palette256 palette(Palettes::Lava);
+            return palette;
+        }
+    }
+
+    NoiseEffect::NoiseEffect(const Palette256 *palette, uint16_t scale, uint16_t speed, uint32_t offset)
+        : palette(palette != nullptr ? palette : &lavaPalette()), scale(scale), speed(speed), offset(offset) {}
+
+    void NoiseEffect::prepare(LedLib &ledLib, const FrameContext &frame) {
+        // Accumulate rather than multiply the absolute time, so changing the speed doesn't jump the pattern
+        depthFraction += frame.delta * speed;
+        depth += depthFraction >> 4;
+        depthFraction &= 0xF;
+    };
+
+    void NoiseEffect::setParam(int param, int32_t value) {
+        switch (param)
+        {
+        case Scale:
+            scale = value;
+            break;
+        case Speed:
+            speed = value;
+            break;
+        }
+    };
+}
@@ -0,0 +1,25 @@
+#include "StrobeEffect.hpp"
+#include "LedLib/LedLib.hpp"
+#include "main.h"
+namespace LedLib {
+    StrobeEffect::StrobeEffect(Color color, uint16_t period, uint16_t onTime, Color background)
+        : color(color), period(period), onTime(onTime), background(background) {}
+
+    void StrobeEffect::prepare(LedLib &ledLib, const FrameContext &frame) {
+        if (period == 0)
+            period = 1;
+        current = frame.time % period < onTime ? color : background;
+    };
+
+    void StrobeEffect::setParam(int param, int32_t value) {
+        switch (param)
+        {
+        case Period:
+            period = value;
+            break;
+        case OnTime:
+            onTime = value;
+            break;
+        }
+    };
+}
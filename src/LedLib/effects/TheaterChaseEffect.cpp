@@ -0,0 +1,29 @@
+#include "TheaterChaseEffect.hpp"
+#include "LedLib/LedLib.hpp"
+#include "main.h"
+namespace LedLib {
+    TheaterChaseEffect::TheaterChaseEffect(Color color, Color background, uint8_t spacing, uint16_t interval)
+        : color(color), background(background), spacing(spacing), interval(interval) {}
+
+    void TheaterChaseEffect::prepare(LedLib &ledLib, const FrameContext &frame) {
+        if (spacing == 0)
+            spacing = 1;
+        if (interval == 0)
+            interval = 1;
+        reciprocal = UINT32_C(0xFFFFFFFF) / spacing + 1;
+        // Count down so the lit LEDs move towards the end of the strip
+        step = spacing - 1 - (frame.time / interval) % spacing;
+    };
+
+    void TheaterChaseEffect::setParam(int param, int32_t value) {
+        switch (param)
+        {
+        case Spacing:
+            spacing = value;
+            break;
+        case Interval:
+            interval = value;
+            break;
+        }
+    };
+}
@@ -0,0 +1,22 @@
+#include "TwinkleEffect.hpp"
+#include "LedLib/LedLib.hpp"
+#include "main.h"
+namespace LedLib {
+    TwinkleEffect::TwinkleEffect(Color color, uint8_t density, uint16_t period, Color background, uint32_t seed)
+        : color(color), density(density), background(background), seed(seed), periodShift(8) {
+        while (periodShift < 15 && (1u << (periodShift + 1)) <= period)
+            periodShift++;
+    };
+
+    void TwinkleEffect::setParam(int param, int32_t value) {
+        switch (param)
+        {
+        case Density:
+            density = value;
+            break;
+        case Seed:
+            seed = value;
+            break;
+        }
+    };
+}
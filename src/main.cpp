@@ -16,7 +16,12 @@ LedLib::LedLib strip(14, 1, 58);
  */
 void initialize()
 {
-
+    RGB color1{255, 0, 0};
+    RGB color2{0, 0, 240};
+    strip.emplaceEffect<RainbowEffect>();
+    strip.emplaceEffect<GraidentEffect>(color1, color2);
+    strip.setActiveEffect(0);
+    strip.start(60);
 }
 
 /**
@@ -63,29 +68,4 @@ void autonomous() {}
  * operator control task will be stopped. Re-enabling the robot will restart the
  * task, not resume it from where it left off.
  */
-void opcontrol()
-{
-
-    cout << "Check";
-    RGB color1;
-    color1.red = 255;
-    RGB color2;
-    color2.blue = 240;
-    cout << "Check";
-    GraidentEffect graident(color1, color2);
-
-    RainbowEffect rainbow;
-
-    cout << "Check";
-    strip.addEffect(&rainbow);
-    //strip.addEffect(&graident);
-
-    strip.setActiveEffect(0);
-    while (true)
-    {
-        // Delay to control the speed of color change
-        strip.updateEffects();
-        delay(15); 
-        //pros::delay(50);
-    }
-}
\ No newline at end of file
+void opcontrol() {}